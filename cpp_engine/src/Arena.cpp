@@ -0,0 +1,60 @@
+#include "Arena.h"
+#include <algorithm>
+
+namespace guardian {
+
+void *Arena::Overflow::do_allocate(size_t size, size_t alignment) {
+  void *p = std::pmr::new_delete_resource()->allocate(size, alignment);
+  bytes += size;
+  return p;
+}
+
+void Arena::Overflow::do_deallocate(void *p, size_t size, size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+Arena::Arena(size_t initialBytes, size_t maxRetainedBytes)
+    : maxRetained_(maxRetainedBytes),
+      bufferSize_(std::min(initialBytes, maxRetainedBytes)),
+      buffer_(new std::byte[bufferSize_]) {
+  resource_.emplace(buffer_.get(), bufferSize_, &overflow_);
+}
+
+void Arena::reset() {
+  // Destroying the resource returns the overflow to the heap
+  resource_.reset();
+  if (overflow_.bytes > 0 && bufferSize_ < maxRetained_) {
+    bufferSize_ = std::min(bufferSize_ + overflow_.bytes, maxRetained_);
+    buffer_.reset(new std::byte[bufferSize_]);
+  }
+  overflow_.bytes = 0;
+  resource_.emplace(buffer_.get(), bufferSize_, &overflow_);
+}
+
+ArenaPool::Lease::~Lease() {
+  if (!arena_) {
+    return; // Moved from
+  }
+  arena_->reset();
+  auto &pool = ArenaPool::idle();
+  if (pool.size() < MAX_IDLE) {
+    pool.push_back(std::move(arena_));
+  }
+}
+
+ArenaPool::Lease ArenaPool::acquire() {
+  auto &pool = idle();
+  if (pool.empty()) {
+    return Lease(std::make_unique<Arena>());
+  }
+  std::unique_ptr<Arena> arena = std::move(pool.back());
+  pool.pop_back();
+  return Lease(std::move(arena));
+}
+
+std::vector<std::unique_ptr<Arena>> &ArenaPool::idle() {
+  thread_local std::vector<std::unique_ptr<Arena>> pool;
+  return pool;
+}
+
+} // namespace guardian
@@ -0,0 +1,99 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * Arena - Monotonic memory for the intermediate data of one request
+ *
+ * Allocations are bump-pointer from a retained buffer; deallocation is a
+ * no-op and reset() frees everything at once. When a request overflows
+ * the buffer, the overflow comes from the global heap and the buffer is
+ * grown to the request's total (up to maxRetainedBytes) on reset, so a
+ * steady stream of similar requests runs without heap allocations.
+ */
+class Arena {
+public:
+  explicit Arena(size_t initialBytes = 64 * 1024,
+                 size_t maxRetainedBytes = 64 * 1024 * 1024);
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  std::pmr::memory_resource *resource() { return &*resource_; }
+
+  /**
+   * Free all allocations; everything allocated from resource() dangles
+   */
+  void reset();
+
+  size_t capacity() const { return bufferSize_; }          // Retained bytes
+  size_t overflowBytes() const { return overflow_.bytes; } // Since reset
+
+private:
+  // Heap upstream that counts what the buffer could not hold
+  struct Overflow : std::pmr::memory_resource {
+    size_t bytes = 0;
+
+    void *do_allocate(size_t size, size_t alignment) override;
+    void do_deallocate(void *p, size_t size, size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource &other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  size_t maxRetained_;
+  size_t bufferSize_;
+  std::unique_ptr<std::byte[]> buffer_;
+  Overflow overflow_;
+  std::optional<std::pmr::monotonic_buffer_resource> resource_;
+};
+
+/**
+ * ArenaPool - Reusable arenas, pooled per thread
+ *
+ * acquire() hands out an idle arena of the calling thread (or a new one);
+ * the lease resets it and returns it to the pool of the thread that drops
+ * it, so concurrent requests never share an arena or contend on a lock.
+ */
+class ArenaPool {
+public:
+  class Lease {
+  public:
+    Lease(Lease &&) noexcept = default;
+    Lease &operator=(Lease &&) = delete;
+    ~Lease();
+
+    std::pmr::memory_resource *resource() const { return arena_->resource(); }
+    Arena &arena() const { return *arena_; }
+
+  private:
+    friend class ArenaPool;
+    explicit Lease(std::unique_ptr<Arena> arena) : arena_(std::move(arena)) {}
+
+    std::unique_ptr<Arena> arena_;
+  };
+
+  static constexpr size_t MAX_IDLE = 4; // Per thread; extra arenas are freed
+
+  static Lease acquire();
+
+  /**
+   * Idle arenas in the calling thread's pool
+   */
+  static size_t idleCount() { return idle().size(); }
+
+private:
+  static std::vector<std::unique_ptr<Arena>> &idle();
+};
+
+} // namespace guardian
+
+#endif // ARENA_H
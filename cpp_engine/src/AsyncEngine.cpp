@@ -0,0 +1,84 @@
+#include "AsyncEngine.h"
+#include "IoService.h"
+#include "PDFShredder.h"
+#include "RabinKarpDedup.h"
+#include "TextChunker.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace guardian {
+
+Task<std::vector<std::string>> extractTextAsync(std::string filepath,
+                                                ResourceLimits limits) {
+  std::vector<char> data = co_await IoService::instance().read(filepath);
+  // Resumed on a pool worker
+  PDFShredder shredder(limits);
+  co_return shredder.extractTextFromMemory(std::move(data));
+}
+
+Task<std::vector<std::string>> processPdfAsync(std::string filepath,
+                                               PipelineOptions options,
+                                               ResourceLimits limits) {
+  std::vector<std::string> pages =
+      co_await extractTextAsync(std::move(filepath), limits);
+
+  TextChunker chunker(options.chunkSize, options.overlapSize);
+  std::vector<std::string> chunks = chunker.chunkMultiple(pages);
+  if (!options.dedup) {
+    co_return chunks;
+  }
+  RabinKarpDeduplicator deduplicator(options.similarityThreshold);
+  co_return deduplicator.deduplicate(chunks);
+}
+
+namespace {
+
+// Shared by the lanes of processPdfs
+struct Batch {
+  const std::vector<std::string> &filepaths;
+  const PipelineOptions &options;
+  const ResourceLimits &limits;
+  std::atomic<size_t> next{0};
+  std::vector<std::vector<std::string>> results;
+  std::vector<std::exception_ptr> errors;
+};
+
+// One document at a time, taking the next unclaimed one when done
+Task<> lane(Batch &batch) {
+  for (size_t i; (i = batch.next.fetch_add(1)) < batch.filepaths.size();) {
+    try {
+      batch.results[i] = co_await processPdfAsync(batch.filepaths[i],
+                                                  batch.options, batch.limits);
+    } catch (...) {
+      batch.errors[i] = std::current_exception();
+    }
+  }
+}
+
+} // namespace
+
+std::vector<std::vector<std::string>>
+processPdfs(const std::vector<std::string> &filepaths,
+            const PipelineOptions &options, const ResourceLimits &limits,
+            size_t maxDocuments) {
+  TextChunker::validate(options.chunkSize, options.overlapSize);
+  if (maxDocuments == 0)
+    maxDocuments = 2 * ThreadPool::instance().size();
+
+  Batch batch{filepaths, options, limits, {}, {}, {}};
+  batch.results.resize(filepaths.size());
+  batch.errors.resize(filepaths.size());
+  std::vector<Task<>> lanes;
+  for (size_t l = 0; l < std::min(maxDocuments, filepaths.size()); ++l)
+    lanes.push_back(lane(batch));
+  syncWait(whenAll(std::move(lanes)));
+
+  for (const auto &error : batch.errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
+  return std::move(batch.results);
+}
+
+} // namespace guardian
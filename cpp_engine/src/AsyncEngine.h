@@ -0,0 +1,54 @@
+#ifndef ASYNC_ENGINE_H
+#define ASYNC_ENGINE_H
+
+#include "ProcessingPipeline.h"
+#include "ResourceGuard.h"
+#include "Task.h"
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * Asynchronous per-document processing
+ *
+ * Each document is one coroutine: its file is read on the IoService
+ * threads, and parsing, chunking and deduplication continue on the shared
+ * ThreadPool, with its own extractor and deduplicator (neither is shared
+ * between documents). A waiting document holds no thread, so a pool of a
+ * few workers keeps many uploads in flight.
+ */
+
+/**
+ * Read and extract the text of one PDF
+ * @throws std::runtime_error if file cannot be opened or parsed
+ * @throws ResourceLimitError if the document exceeds a resource limit
+ */
+Task<std::vector<std::string>>
+extractTextAsync(std::string filepath, ResourceLimits limits = {});
+
+/**
+ * Extract, chunk and deduplicate one PDF; chunkThreads and queueCapacity
+ * of the options are not used
+ * @return Unique chunks in document order
+ */
+Task<std::vector<std::string>>
+processPdfAsync(std::string filepath, PipelineOptions options = {},
+                ResourceLimits limits = {});
+
+/**
+ * Process documents concurrently, blocking until all have finished. At
+ * most maxDocuments are in flight (read, parsed or chunked) at a time, so
+ * a long list does not load every file at once.
+ * @param maxDocuments 0 = twice the workers of the shared pool
+ * @return Unique chunks of each document, in the order of filepaths
+ * @throws The first error (in document order) once all have finished
+ */
+std::vector<std::vector<std::string>>
+processPdfs(const std::vector<std::string> &filepaths,
+            const PipelineOptions &options = {},
+            const ResourceLimits &limits = {}, size_t maxDocuments = 0);
+
+} // namespace guardian
+
+#endif // ASYNC_ENGINE_H
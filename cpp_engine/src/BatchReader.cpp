@@ -0,0 +1,438 @@
+#include "BatchReader.h"
+#include "PDFShredder.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define GUARDIAN_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace guardian {
+
+namespace {
+
+// Largest single read request (io_uring lengths are 32-bit)
+constexpr size_t MAX_READ = 1u << 30;
+
+std::exception_ptr readError(const std::string &path) {
+  return std::make_exception_ptr(
+      std::runtime_error("Failed to read PDF: " + path));
+}
+
+} // namespace
+
+#ifdef GUARDIAN_IO_URING
+
+/**
+ * Ring - Minimal io_uring over raw system calls (no liburing dependency):
+ * one submission queue entry per read, completions reaped by the consumer
+ */
+class BatchReader::Ring {
+public:
+  /**
+   * @return nullptr if the kernel does not allow io_uring
+   */
+  static std::unique_ptr<Ring> create(unsigned entries,
+                                      std::vector<Slot> &slots,
+                                      size_t bufferBytes) {
+    io_uring_params params{};
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+      return nullptr;
+    }
+    std::unique_ptr<Ring> ring(new Ring(fd));
+    if (!ring->map(params)) {
+      return nullptr;
+    }
+
+    // Registered buffers are pinned once instead of on every read; this
+    // fails under a low RLIMIT_MEMLOCK, and plain reads are used instead
+    std::vector<iovec> buffers(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i)
+      buffers[i] = {slots[i].buffer.get(), bufferBytes};
+    ring->registered_ =
+        syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS,
+                buffers.data(), static_cast<unsigned>(buffers.size())) == 0;
+    return ring;
+  }
+
+  ~Ring() {
+    if (sqes_ != MAP_FAILED)
+      munmap(sqes_, sqesBytes_);
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_)
+      munmap(cqRing_, cqBytes_);
+    if (sqRing_ != MAP_FAILED)
+      munmap(sqRing_, sqBytes_);
+    close(fd_);
+  }
+
+  /**
+   * Queue a read of [offset, offset + length) into target; fixed reads
+   * use the registered buffer of the slot
+   */
+  void read(size_t slot, int fd, char *target, size_t length,
+            uint64_t offset, bool fixed) {
+    unsigned tail = *sqTail_;
+    unsigned index = tail & *sqMask_;
+    io_uring_sqe &sqe = sqes_[index];
+    sqe = {};
+    sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(target);
+    sqe.len = static_cast<unsigned>(length);
+    sqe.off = offset;
+    sqe.user_data = slot;
+    if (fixed)
+      sqe.buf_index = static_cast<uint16_t>(slot);
+    sqArray_[index] = index;
+    std::atomic_ref<unsigned>(*sqTail_).store(tail + 1,
+                                              std::memory_order_release);
+    ++unsubmitted_;
+  }
+
+  /**
+   * Submit queued reads and, if wait is set, block for a completion;
+   * onComplete(slot, result) is called for each completion
+   */
+  template <typename F> void run(bool wait, F &&onComplete) {
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    if (unsubmitted_ > 0 || wait) {
+      long submitted = syscall(__NR_io_uring_enter, fd_, unsubmitted_,
+                               wait ? 1u : 0u, flags, nullptr, 0);
+      if (submitted < 0 && errno != EINTR) {
+        throw std::runtime_error("io_uring_enter failed");
+      }
+      if (submitted > 0)
+        unsubmitted_ -= static_cast<unsigned>(submitted);
+    }
+
+    unsigned head = *cqHead_;
+    unsigned tail =
+        std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      const io_uring_cqe &cqe = cqes_[head & *cqMask_];
+      onComplete(static_cast<size_t>(cqe.user_data), cqe.res);
+    }
+    std::atomic_ref<unsigned>(*cqHead_).store(head, std::memory_order_release);
+  }
+
+  bool registered() const { return registered_; }
+
+private:
+  explicit Ring(int fd) : fd_(fd) {}
+
+  bool map(const io_uring_params &params) {
+    sqBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqBytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+      sqBytes_ = cqBytes_ = std::max(sqBytes_, cqBytes_);
+
+    sqRing_ = mmap(nullptr, sqBytes_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED)
+      return false;
+    cqRing_ = single ? sqRing_
+                     : mmap(nullptr, cqBytes_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd_,
+                            IORING_OFF_CQ_RING);
+    if (cqRing_ == MAP_FAILED)
+      return false;
+    sqesBytes_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, sqesBytes_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+      return false;
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sqRing_);
+    sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  int fd_;
+  bool registered_ = false;
+  unsigned unsubmitted_ = 0;
+  void *sqRing_ = MAP_FAILED;
+  void *cqRing_ = MAP_FAILED;
+  io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+  size_t sqBytes_ = 0, cqBytes_ = 0, sqesBytes_ = 0;
+  unsigned *sqTail_, *sqMask_, *sqArray_;
+  unsigned *cqHead_, *cqTail_, *cqMask_;
+  io_uring_cqe *cqes_;
+};
+
+#else
+
+// No io_uring on this platform: always the pread fallback
+class BatchReader::Ring {
+public:
+  static std::unique_ptr<Ring> create(unsigned, std::vector<Slot> &,
+                                      size_t) {
+    return nullptr;
+  }
+
+  void read(size_t, int, char *, size_t, uint64_t, bool) {}
+  template <typename F> void run(bool, F &&) {}
+  bool registered() const { return false; }
+};
+
+#endif
+
+BatchReader::BatchReader(std::vector<std::string> paths,
+                         const BatchReaderOptions &options)
+    : paths_(std::move(paths)), options_(options) {
+  options_.prefetch = std::max<size_t>(options_.prefetch, 1);
+  options_.bufferBytes = std::max<size_t>(options_.bufferBytes, 4096);
+
+  // One slot more than the read-ahead: the consumer holds one
+  slots_.resize(options_.prefetch + 1);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    slots_[i].buffer.reset(new char[options_.bufferBytes]); // Uninitialized
+    free_.push_back(slots_.size() - 1 - i);
+  }
+
+  if (options_.useIoUring) {
+    unsigned entries = 1;
+    while (entries < slots_.size())
+      entries *= 2;
+    ring_ = Ring::create(entries, slots_, options_.bufferBytes);
+  }
+  stats_.ioUring = ring_ != nullptr;
+  if (!ring_) {
+    unsigned threads = std::max(options_.readThreads, 1u);
+    for (unsigned i = 0; i < threads; ++i)
+      readers_.emplace_back(&BatchReader::readerLoop, this);
+  }
+}
+
+BatchReader::~BatchReader() {
+  if (ring_) {
+    // The kernel may still write into the buffers: drain before freeing
+    while (std::any_of(inFlight_.begin(), inFlight_.end(),
+                       [this](size_t s) { return !slots_[s].finished; })) {
+      ring_->run(true, [this](size_t s, int result) { complete(s, result); });
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_all();
+  for (auto &reader : readers_)
+    reader.join();
+  for (auto &slot : slots_)
+    finish(slot);
+}
+
+bool BatchReader::next(File &file) {
+  if (returned_ != static_cast<size_t>(-1)) {
+    slots_[returned_].large = std::vector<char>(); // Rare; not retained
+    free_.push_back(returned_);
+    returned_ = static_cast<size_t>(-1);
+  }
+  fill();
+  if (inFlight_.empty()) {
+    return false;
+  }
+
+  const size_t s = inFlight_.front();
+  Slot &slot = slots_[s];
+  if (ring_) {
+    while (!slot.finished) {
+      ring_->run(true, [this](size_t s, int result) { complete(s, result); });
+    }
+  } else {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [&slot] { return slot.finished; });
+  }
+  inFlight_.pop_front();
+  returned_ = s;
+
+  file.index = slot.file;
+  file.path = &paths_[slot.file];
+  file.data = slot.target;
+  file.size = slot.error ? 0 : slot.size;
+  file.error = slot.error;
+  if (slot.target != slot.buffer.get())
+    ++stats_.largeFiles;
+  ++stats_.files;
+  stats_.bytes += file.size;
+
+  fill(); // Keep the read-ahead full while the consumer parses
+  return true;
+}
+
+void BatchReader::fill() {
+  while (!free_.empty() && nextFile_ < paths_.size()) {
+    size_t s = free_.back();
+    free_.pop_back();
+    Slot &slot = slots_[s];
+    slot.file = nextFile_++;
+    slot.fd = -1;
+    slot.size = slot.done = 0;
+    slot.finished = false;
+    slot.error = nullptr;
+    inFlight_.push_back(s);
+    start(s);
+  }
+  if (ring_) {
+    ring_->run(false, [this](size_t s, int result) { complete(s, result); });
+  }
+}
+
+void BatchReader::start(size_t s) {
+  if (!ring_) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(s);
+    }
+    queued_.notify_one();
+    return;
+  }
+
+  Slot &slot = slots_[s];
+  const std::string &path = paths_[slot.file];
+  struct stat info;
+  slot.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (slot.fd < 0 || fstat(slot.fd, &info) != 0) {
+    slot.error = std::make_exception_ptr(
+        std::runtime_error("Failed to open PDF: " + path));
+    slot.finished = true;
+    finish(slot);
+    return;
+  }
+  slot.size = static_cast<size_t>(info.st_size);
+  if (slot.size <= options_.bufferBytes) {
+    slot.target = slot.buffer.get();
+  } else {
+    slot.large.resize(slot.size);
+    slot.target = slot.large.data();
+  }
+  if (slot.size == 0) {
+    slot.finished = true;
+    finish(slot);
+    return;
+  }
+  ring_->read(s, slot.fd, slot.target, std::min(slot.size, MAX_READ), 0,
+              ring_->registered() && slot.target == slot.buffer.get());
+}
+
+void BatchReader::complete(size_t s, int result) {
+  Slot &slot = slots_[s];
+  if (result < 0 || (result == 0 && slot.done < slot.size)) {
+    slot.error = readError(paths_[slot.file]);
+  } else {
+    slot.done += static_cast<size_t>(result);
+    if (slot.done < slot.size) {
+      // Short read: queue the rest
+      ring_->read(s, slot.fd, slot.target + slot.done,
+                  std::min(slot.size - slot.done, MAX_READ), slot.done,
+                  ring_->registered() && slot.target == slot.buffer.get());
+      return;
+    }
+  }
+  slot.finished = true;
+  finish(slot);
+}
+
+void BatchReader::finish(Slot &slot) {
+  if (slot.fd >= 0) {
+    close(slot.fd);
+    slot.fd = -1;
+  }
+}
+
+void BatchReader::readerLoop() {
+  for (;;) {
+    size_t s;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queued_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return; // Stopping and drained
+      }
+      s = jobs_.front();
+      jobs_.pop_front();
+    }
+
+    // The consumer does not touch the slot until it is finished
+    Slot &slot = slots_[s];
+    const std::string &path = paths_[slot.file];
+    struct stat info;
+    slot.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (slot.fd < 0 || fstat(slot.fd, &info) != 0) {
+      slot.error = std::make_exception_ptr(
+          std::runtime_error("Failed to open PDF: " + path));
+    } else {
+      slot.size = static_cast<size_t>(info.st_size);
+      if (slot.size <= options_.bufferBytes) {
+        slot.target = slot.buffer.get();
+      } else {
+        slot.large.resize(slot.size);
+        slot.target = slot.large.data();
+      }
+      while (slot.done < slot.size) {
+        ssize_t n = pread(slot.fd, slot.target + slot.done,
+                          std::min(slot.size - slot.done, MAX_READ),
+                          static_cast<off_t>(slot.done));
+        if (n < 0 && errno == EINTR)
+          continue;
+        if (n <= 0) {
+          slot.error = readError(path);
+          break;
+        }
+        slot.done += static_cast<size_t>(n);
+      }
+    }
+    finish(slot);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      slot.finished = true;
+    }
+    finished_.notify_all();
+  }
+}
+
+void extractBatch(const std::vector<std::string> &paths,
+                  const BatchCallback &onDocument,
+                  const BatchReaderOptions &options,
+                  const ResourceLimits &limits) {
+  BatchReader reader(paths, options);
+  PDFShredder shredder(limits);
+  BatchReader::File file;
+  BatchDocument document;
+  while (reader.next(file)) {
+    document.index = file.index;
+    document.path = *file.path;
+    document.pages.clear();
+    document.error.clear();
+    try {
+      if (file.error)
+        std::rethrow_exception(file.error);
+      document.pages = shredder.extractTextFromMemory(file.data, file.size);
+    } catch (const std::exception &e) {
+      document.error = e.what();
+    }
+    onDocument(std::move(document));
+  }
+}
+
+} // namespace guardian
@@ -0,0 +1,142 @@
+#ifndef BATCH_READER_H
+#define BATCH_READER_H
+
+#include "ResourceGuard.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * BatchReaderOptions - Read-ahead depth and buffers of a BatchReader
+ */
+struct BatchReaderOptions {
+  size_t prefetch = 8;                  // Files read ahead of the consumer
+  size_t bufferBytes = 4 * 1024 * 1024; // Per buffer; larger files get
+                                        // their own allocation
+  bool useIoUring = true;               // Otherwise pread threads
+  unsigned readThreads = 4;             // pread fallback only
+};
+
+/**
+ * BatchReader - Reads a list of files ahead of their consumer
+ *
+ * Up to prefetch files are in flight at once, each into one of prefetch
+ * buffers allocated up front, while the consumer parses earlier files, so
+ * on a cold cache the disk stays busy during extraction. On Linux the
+ * reads go through an io_uring with the buffers registered (fixed-buffer
+ * reads, no per-read page pinning); where io_uring is unavailable
+ * (older kernels, seccomp) or disabled, readThreads threads issue pread
+ * calls instead. Files are opened synchronously when their read is
+ * queued; only the data transfer is asynchronous.
+ *
+ * Files are returned in list order. A returned file's data stays valid
+ * until the next call to next(); then its buffer is reused.
+ */
+class BatchReader {
+public:
+  struct File {
+    size_t index = 0;
+    const std::string *path = nullptr;
+    const char *data = nullptr;
+    size_t size = 0;
+    std::exception_ptr error; // Set if the file could not be read
+  };
+
+  explicit BatchReader(std::vector<std::string> paths,
+                       const BatchReaderOptions &options = {});
+  ~BatchReader();
+
+  BatchReader(const BatchReader &) = delete;
+  BatchReader &operator=(const BatchReader &) = delete;
+
+  /**
+   * Wait for the next file in list order
+   * @return false once every file has been returned
+   */
+  bool next(File &file);
+
+  struct Stats {
+    size_t files;      // Files returned
+    size_t bytes;      // Bytes read
+    size_t largeFiles; // Files too large for a buffer
+    bool ioUring;      // Reads go through io_uring
+  };
+
+  Stats getStats() const { return stats_; }
+
+private:
+  struct Slot {
+    std::unique_ptr<char[]> buffer; // bufferBytes
+    std::vector<char> large;        // Files larger than the buffer
+    char *target = nullptr;         // buffer or large
+    size_t file = 0;
+    int fd = -1;
+    size_t size = 0;
+    size_t done = 0; // Bytes read so far
+    bool finished = false;
+    std::exception_ptr error;
+  };
+
+  class Ring;
+
+  std::vector<std::string> paths_;
+  BatchReaderOptions options_;
+  std::vector<Slot> slots_;
+  std::vector<size_t> free_;    // Idle slots
+  std::deque<size_t> inFlight_; // Slots in file order
+  size_t nextFile_ = 0;         // Next file to start reading
+  size_t returned_ = static_cast<size_t>(-1); // Slot handed out last
+  Stats stats_{};
+
+  std::unique_ptr<Ring> ring_; // nullptr: pread threads
+
+  // pread fallback
+  std::vector<std::thread> readers_;
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  std::condition_variable finished_;
+  std::deque<size_t> jobs_;
+  bool stopping_ = false;
+
+  void fill();
+  void start(size_t slot);
+  void complete(size_t slot, int result); // io_uring completion
+  void finish(Slot &slot);
+  void readerLoop();
+};
+
+/**
+ * BatchDocument - Extraction result of one file of a batch
+ */
+struct BatchDocument {
+  size_t index = 0;
+  std::string path;
+  std::vector<std::string> pages;
+  std::string error; // Empty on success
+};
+
+using BatchCallback = std::function<void(BatchDocument document)>;
+
+/**
+ * Extract the text of many PDFs, reading upcoming files while earlier
+ * ones are parsed. Documents are passed to onDocument in list order; a
+ * document that cannot be read or parsed carries its error instead of
+ * ending the batch.
+ */
+void extractBatch(const std::vector<std::string> &paths,
+                  const BatchCallback &onDocument,
+                  const BatchReaderOptions &options = {},
+                  const ResourceLimits &limits = {});
+
+} // namespace guardian
+
+#endif // BATCH_READER_H
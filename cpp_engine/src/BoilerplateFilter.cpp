@@ -0,0 +1,117 @@
+#include "BoilerplateFilter.h"
+#include <algorithm>
+
+namespace guardian {
+
+namespace {
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Comparison key: surrounding blanks trimmed, digits masked
+void lineKey(const std::string &page, size_t begin, size_t end,
+             std::string &key) {
+  while (begin < end && isBlank(page[begin]))
+    ++begin;
+  while (end > begin && isBlank(page[end - 1]))
+    --end;
+  key.assign(page, begin, end - begin);
+  for (char &c : key) {
+    if (c >= '0' && c <= '9')
+      c = '#';
+  }
+}
+
+} // namespace
+
+BoilerplateFilter::BoilerplateFilter(const BoilerplateOptions &options)
+    : options_(options) {}
+
+void BoilerplateFilter::strip(std::vector<std::string> &pages) {
+  stats_ = {};
+  if (pages.size() < static_cast<size_t>(std::max(options_.minPages, 1))) {
+    return;
+  }
+
+  // Non-empty lines within edgeLines of the top or bottom of each page
+  counts_.clear();
+  edges_.resize(pages.size());
+  std::vector<Line> lines;
+  for (size_t p = 0; p < pages.size(); ++p) {
+    const std::string &page = pages[p];
+    lines.clear();
+    for (size_t begin = 0; begin < page.size();) {
+      size_t end = page.find('\n', begin);
+      if (end == std::string::npos)
+        end = page.size();
+      lineKey(page, begin, end, key_);
+      if (!key_.empty())
+        lines.push_back({begin, end});
+      begin = end + 1;
+    }
+
+    std::vector<Line> &edges = edges_[p];
+    edges.clear();
+    size_t n = static_cast<size_t>(std::max(options_.edgeLines, 0));
+    for (size_t i = 0; i < lines.size(); ++i) {
+      if (i < n || i + n >= lines.size())
+        edges.push_back(lines[i]);
+    }
+
+    // Count each key once per page
+    seen_.clear();
+    for (const Line &line : edges) {
+      if (line.end - line.begin > options_.maxLineBytes)
+        continue;
+      lineKey(page, line.begin, line.end, key_);
+      if (std::find(seen_.begin(), seen_.end(), key_) == seen_.end()) {
+        seen_.push_back(key_);
+        ++counts_[key_];
+      }
+    }
+  }
+
+  const double threshold = std::max(
+      static_cast<double>(options_.minPages),
+      options_.minPageFraction * static_cast<double>(pages.size()));
+  for (const auto &[key, count] : counts_) {
+    if (count >= threshold)
+      ++stats_.patterns;
+  }
+  if (stats_.patterns == 0) {
+    return;
+  }
+
+  // Remove matching edge lines, back to front so offsets stay valid
+  for (size_t p = 0; p < pages.size(); ++p) {
+    std::string &page = pages[p];
+    const std::vector<Line> &edges = edges_[p];
+    size_t removed = stats_.linesRemoved;
+    for (auto it = edges.rbegin(); it != edges.rend(); ++it) {
+      if (it->end - it->begin > options_.maxLineBytes)
+        continue;
+      lineKey(page, it->begin, it->end, key_);
+      auto found = counts_.find(key_);
+      if (found == counts_.end() || found->second < threshold)
+        continue;
+      size_t end = it->end < page.size() ? it->end + 1 : it->end;
+      page.erase(it->begin, end - it->begin);
+      ++stats_.linesRemoved;
+    }
+
+    if (stats_.linesRemoved == removed) {
+      continue;
+    }
+
+    // Blank lines left at the edges
+    size_t first = page.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+      page.clear();
+      continue;
+    }
+    size_t last = page.find_last_not_of(" \t\r\n");
+    page.erase(last + 1);
+    page.erase(0, first);
+  }
+}
+
+} // namespace guardian
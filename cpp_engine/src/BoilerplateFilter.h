@@ -0,0 +1,67 @@
+#ifndef BOILERPLATE_FILTER_H
+#define BOILERPLATE_FILTER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * BoilerplateOptions - What counts as a running header or footer
+ */
+struct BoilerplateOptions {
+  int edgeLines = 3;            // Lines examined at the top and bottom
+  double minPageFraction = 0.5; // Of all pages a line must repeat on
+  int minPages = 3;             // Shorter documents are left alone
+  size_t maxLineBytes = 200;    // Longer lines are body text
+};
+
+/**
+ * BoilerplateFilter - Removes running headers, footers and page numbers
+ *
+ * A line near the top or bottom of a page is boilerplate if the same line
+ * appears near the edge of at least minPageFraction of the pages. Lines
+ * are compared with ASCII digits masked, so "Page 3 of 10" matches
+ * "Page 4 of 10" and bare page numbers match each other.
+ */
+class BoilerplateFilter {
+public:
+  explicit BoilerplateFilter(
+      const BoilerplateOptions &options = BoilerplateOptions());
+
+  /**
+   * Strip boilerplate lines from the pages of one document, in place
+   */
+  void strip(std::vector<std::string> &pages);
+
+  struct Stats {
+    size_t patterns;     // Distinct boilerplate lines found
+    size_t linesRemoved; // Over all pages
+  };
+
+  /**
+   * Statistics of the last strip() call
+   */
+  Stats getStats() const { return stats_; }
+
+  const BoilerplateOptions &getOptions() const { return options_; }
+
+private:
+  struct Line {
+    size_t begin, end; // [begin, end) of the line, without its '\n'
+  };
+
+  BoilerplateOptions options_;
+  Stats stats_{};
+
+  // Scratch reused across documents
+  std::unordered_map<std::string, size_t> counts_; // Key -> pages
+  std::vector<std::vector<Line>> edges_;           // Edge lines per page
+  std::vector<std::string> seen_;                  // Keys of one page
+  std::string key_;
+};
+
+} // namespace guardian
+
+#endif // BOILERPLATE_FILTER_H
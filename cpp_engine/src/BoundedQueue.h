@@ -0,0 +1,159 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace guardian {
+
+/**
+ * BoundedQueue - Lock-free multi-producer multi-consumer ring buffer
+ *
+ * Each slot carries a sequence number telling producers and consumers
+ * whose turn it is (D. Vyukov's bounded MPMC queue), so tryPush/tryPop
+ * are a single CAS on the tail or head. The blocking push/pop back off
+ * from spinning to yielding to short sleeps: a full queue stalls its
+ * producers (backpressure) without burning a core.
+ *
+ * close() ends the stream: push fails from then on, and pop fails once
+ * the queue is drained.
+ */
+template <typename T> class BoundedQueue {
+public:
+  /**
+   * @param capacity Slots, rounded up to a power of two (at least 2)
+   */
+  explicit BoundedQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity)
+      size *= 2;
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  /**
+   * Push without waiting; value is moved from only on success
+   */
+  bool tryPush(T &value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false; // Full
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPop(T &value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false; // Empty
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Wait for a free slot
+   * @return false if the queue was closed (value is left untouched)
+   */
+  bool push(T &value) {
+    for (Backoff backoff;; backoff.pause()) {
+      if (closed_.load(std::memory_order_acquire))
+        return false;
+      if (tryPush(value))
+        return true;
+    }
+  }
+
+  /**
+   * Wait for a value
+   * @return false once the queue is closed and empty
+   */
+  bool pop(T &value) {
+    for (Backoff backoff;; backoff.pause()) {
+      if (tryPop(value))
+        return true;
+      // Values pushed before close() are visible once closed_ is
+      if (closed_.load(std::memory_order_acquire))
+        return tryPop(value);
+    }
+  }
+
+  void close() { closed_.store(true, std::memory_order_release); }
+
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  size_t capacity() const { return mask_ + 1; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  class Backoff {
+  public:
+    void pause() {
+      if (rounds_ < 64) {
+        ++rounds_; // Spin: the other side is usually mid-operation
+      } else if (rounds_ < 128) {
+        ++rounds_;
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+
+  private:
+    int rounds_ = 0;
+  };
+
+  static constexpr size_t CACHE_LINE = 64;
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+  alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+  alignas(CACHE_LINE) std::atomic<bool> closed_{false};
+};
+
+} // namespace guardian
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,136 @@
+#include "CaseFolder.h"
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace guardian {
+
+namespace {
+
+constexpr uint32_t TABLE_END = 0x500;
+
+// Simple case folding for U+0000-U+04FF; 0 means "maps to itself"
+struct FoldTable {
+  uint16_t map[TABLE_END];
+
+  constexpr void pairs(uint32_t first, uint32_t last, uint32_t parity) {
+    for (uint32_t c = first; c <= last; ++c)
+      if (c % 2 == parity)
+        map[c] = static_cast<uint16_t>(c + 1);
+  }
+
+  constexpr void shift(uint32_t first, uint32_t last, uint32_t delta) {
+    for (uint32_t c = first; c <= last; ++c)
+      map[c] = static_cast<uint16_t>(c + delta);
+  }
+
+  constexpr FoldTable() : map() {
+    // Basic Latin and Latin-1 Supplement
+    shift('A', 'Z', 0x20);
+    shift(0xC0, 0xDE, 0x20);
+    map[0xD7] = 0; // Multiplication sign
+    map[0xB5] = 0x3BC; // Micro sign -> Greek mu
+
+    // Latin Extended-A (U+0130 and U+0149 have no simple folding)
+    pairs(0x100, 0x12F, 0);
+    pairs(0x132, 0x137, 0);
+    pairs(0x139, 0x148, 1);
+    pairs(0x14A, 0x177, 0);
+    map[0x178] = 0xFF;
+    pairs(0x179, 0x17E, 1);
+    map[0x17F] = 's';
+
+    // Greek
+    map[0x386] = 0x3AC;
+    shift(0x388, 0x38A, 0x25);
+    map[0x38C] = 0x3CC;
+    shift(0x38E, 0x38F, 0x3F);
+    shift(0x391, 0x3A1, 0x20);
+    shift(0x3A3, 0x3AB, 0x20);
+    map[0x3C2] = 0x3C3; // Final sigma
+
+    // Cyrillic
+    shift(0x400, 0x40F, 0x50);
+    shift(0x410, 0x42F, 0x20);
+    pairs(0x460, 0x481, 0);
+    pairs(0x48A, 0x4BF, 0);
+    map[0x4C0] = 0x4CF;
+    pairs(0x4C1, 0x4CE, 1);
+    pairs(0x4D0, 0x4FF, 0);
+  }
+};
+
+constexpr FoldTable FOLD;
+
+#if defined(__SSE2__)
+// Lower-case 16 ASCII bytes; returns false if any byte is non-ASCII
+bool foldAsciiBlock(const char *in, char *out) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  if (_mm_movemask_epi8(v) != 0) {
+    return false;
+  }
+  __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+  v = _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+  return true;
+}
+#endif
+
+} // namespace
+
+void CaseFolder::fold(const char *data, size_t size, std::string &out) {
+  size_t base = out.size();
+  out.resize(base + size);
+  char *dst = &out[0] + base;
+  const unsigned char *in = reinterpret_cast<const unsigned char *>(data);
+  size_t r = 0, w = 0;
+
+  while (r < size) {
+#if defined(__SSE2__)
+    if (r + 16 <= size && foldAsciiBlock(data + r, dst + w)) {
+      r += 16;
+      w += 16;
+      continue;
+    }
+#endif
+    unsigned char c = in[r];
+    if (c < 0x80) {
+      dst[w++] = static_cast<char>(FOLD.map[c] ? FOLD.map[c] : c);
+      ++r;
+      continue;
+    }
+
+    // Everything in the table is a two-byte sequence (lead C2..D3)
+    if (c >= 0xC2 && c <= 0xD3 && r + 1 < size && (in[r + 1] & 0xC0) == 0x80) {
+      uint32_t cp = ((c & 0x1Fu) << 6) | (in[r + 1] & 0x3Fu);
+      uint32_t folded = FOLD.map[cp];
+      if (folded >= 0x80) {
+        dst[w++] = static_cast<char>(0xC0 | (folded >> 6));
+        dst[w++] = static_cast<char>(0x80 | (folded & 0x3F));
+        r += 2;
+        continue;
+      }
+      if (folded) {
+        dst[w++] = static_cast<char>(folded);
+        r += 2;
+        continue;
+      }
+    }
+
+    dst[w++] = static_cast<char>(c);
+    ++r;
+  }
+
+  out.resize(base + w);
+}
+
+std::string CaseFolder::fold(const std::string &text) {
+  std::string out;
+  fold(text.data(), text.size(), out);
+  return out;
+}
+
+} // namespace guardian
@@ -0,0 +1,35 @@
+#ifndef CASE_FOLDER_H
+#define CASE_FOLDER_H
+
+#include <cstddef>
+#include <string>
+
+namespace guardian {
+
+/**
+ * CaseFolder - Unicode simple case folding for comparison keys
+ *
+ * Folds ASCII 16 bytes at a time (SSE2) and maps Latin-1, Latin
+ * Extended-A, Greek and Cyrillic through a compact code point table
+ * (U+0080-U+04FF). Other scripts are copied unchanged. Folded text is
+ * never longer than its input.
+ */
+class CaseFolder {
+public:
+  /**
+   * Append the case-folded form of a UTF-8 buffer to out
+   * @param data UTF-8 input
+   * @param size Input length in bytes
+   * @param out Scratch buffer to append to (reused across calls)
+   */
+  static void fold(const char *data, size_t size, std::string &out);
+
+  /**
+   * Convenience overload returning a new string
+   */
+  static std::string fold(const std::string &text);
+};
+
+} // namespace guardian
+
+#endif // CASE_FOLDER_H
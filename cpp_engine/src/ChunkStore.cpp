@@ -0,0 +1,93 @@
+#include "ChunkStore.h"
+#include "ChunkWriter.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace guardian {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// FNV-1a: stable across runs and builds, unlike std::hash
+uint64_t pathHash(const std::string &path) {
+  uint64_t h = 1469598103934665603ULL;
+  for (unsigned char c : path) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+std::string hex(uint64_t value) {
+  static const char DIGITS[] = "0123456789abcdef";
+  std::string out(16, '0');
+  for (int i = 15; i >= 0; --i, value >>= 4)
+    out[i] = DIGITS[value & 0xf];
+  return out;
+}
+
+// Unique temporary name suffix, also across processes sharing a store
+std::string tempSuffix() {
+  static const uint64_t process = std::random_device{}();
+  static std::atomic<uint64_t> counter{0};
+  return hex(process) + "." + std::to_string(counter.fetch_add(1)) + ".tmp";
+}
+
+} // namespace
+
+ChunkStore::ChunkStore(std::string directory)
+    : directory_(std::move(directory)) {
+  std::error_code ec;
+  fs::create_directories(directory_, ec);
+  if (ec || !fs::is_directory(directory_)) {
+    throw std::runtime_error("Failed to create chunk store: " + directory_);
+  }
+}
+
+std::string ChunkStore::entryPath(const std::string &source) const {
+  fs::path path = fs::absolute(source).lexically_normal();
+  return (fs::path(directory_) / path.filename()).string() + "." +
+         hex(pathHash(path.string())) + ".ndjson";
+}
+
+bool ChunkStore::upToDate(const std::string &source) const {
+  std::error_code ec;
+  auto entry = fs::last_write_time(entryPath(source), ec);
+  if (ec) {
+    return false;
+  }
+  auto written = fs::last_write_time(source, ec);
+  return !ec && entry >= written;
+}
+
+void ChunkStore::put(const std::string &source,
+                     const PipelineResult &result) {
+  std::string path = entryPath(source);
+  fs::path file(path);
+  std::string temp =
+      (file.parent_path() /
+       ("." + file.filename().string() + "." + tempSuffix()))
+          .string();
+
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    NdjsonWriter(out).write(source, result.chunks);
+    if (!out.flush()) {
+      std::remove(temp.c_str());
+      throw std::runtime_error("Failed to write chunks: " + path);
+    }
+  }
+
+  if (std::rename(temp.c_str(), path.c_str()) != 0) {
+    std::remove(temp.c_str());
+    throw std::runtime_error("Failed to write chunks: " + path);
+  }
+}
+
+} // namespace guardian
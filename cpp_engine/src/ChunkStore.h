@@ -0,0 +1,51 @@
+#ifndef CHUNK_STORE_H
+#define CHUNK_STORE_H
+
+#include "Pipeline.h"
+#include <string>
+
+namespace guardian {
+
+/**
+ * ChunkStore - Directory of per-document chunk files
+ *
+ * The chunks of source file dir/name.pdf are stored as
+ * name.pdf.<hash>.ndjson, written by an NdjsonWriter (one JSON object per
+ * chunk). The hash is taken over the absolute source path, so sources
+ * with the same file name in different directories get entries of their
+ * own.
+ *
+ * Every write goes to a hidden temporary file of its own and is renamed
+ * into place, so readers of the store never see a partial document, and
+ * concurrent writes of one entry leave one of them complete.
+ */
+class ChunkStore {
+public:
+  /**
+   * @throws std::runtime_error if the directory cannot be created
+   */
+  explicit ChunkStore(std::string directory);
+
+  /**
+   * Path of the entry for a source file
+   */
+  std::string entryPath(const std::string &source) const;
+
+  /**
+   * Whether the entry exists and is newer than the source file
+   */
+  bool upToDate(const std::string &source) const;
+
+  /**
+   * Replace the entry of a source file
+   * @throws std::runtime_error if it cannot be written
+   */
+  void put(const std::string &source, const PipelineResult &result);
+
+private:
+  std::string directory_;
+};
+
+} // namespace guardian
+
+#endif // CHUNK_STORE_H
@@ -0,0 +1,104 @@
+#include "ChunkWriter.h"
+#include <stdexcept>
+
+namespace guardian {
+
+namespace {
+
+void appendJson(std::string &out, const std::string &text) {
+  static const char HEX[] = "0123456789abcdef";
+  out += '"';
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        out += "\\u00";
+        out += HEX[(c >> 4) & 0xf];
+        out += HEX[c & 0xf];
+      } else {
+        out += c; // UTF-8 passes through
+      }
+    }
+  }
+  out += '"';
+}
+
+template <typename T> void putLittleEndian(std::ostream &out, T value) {
+  char bytes[sizeof(T)];
+  for (size_t i = 0; i < sizeof(T); ++i)
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  out.write(bytes, sizeof(T));
+}
+
+template <typename T>
+void putColumn(std::ostream &out, const std::vector<T> &column) {
+  for (T value : column)
+    putLittleEndian(out, value);
+}
+
+} // namespace
+
+void NdjsonWriter::write(const std::string &source,
+                         const std::vector<std::string> &chunks) {
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    line_.assign("{\"source\":");
+    appendJson(line_, source);
+    line_ += ",\"chunk\":" + std::to_string(i) + ",\"text\":";
+    appendJson(line_, chunks[i]);
+    line_ += "}\n";
+    out_ << line_;
+  }
+}
+
+ColumnarWriter::ColumnarWriter(std::ostream &out) : out_(out) {
+  out_.write(MAGIC, 8);
+}
+
+void ColumnarWriter::write(const std::string &source,
+                           const std::vector<std::string> &chunks) {
+  if (finished_) {
+    throw std::logic_error("ColumnarWriter is finished");
+  }
+  auto document = static_cast<uint32_t>(sourceOffsets_.size() - 1);
+  sources_ += source;
+  sourceOffsets_.push_back(sources_.size());
+
+  for (const auto &chunk : chunks) {
+    out_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    chunkDocument_.push_back(document);
+    textOffsets_.push_back(textOffsets_.back() + chunk.size());
+  }
+}
+
+void ColumnarWriter::finish() {
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+  uint64_t footerOffset = 8 + textOffsets_.back();
+  putLittleEndian<uint64_t>(out_, sourceOffsets_.size() - 1);
+  putLittleEndian<uint64_t>(out_, chunkDocument_.size());
+  putColumn(out_, sourceOffsets_);
+  out_.write(sources_.data(), static_cast<std::streamsize>(sources_.size()));
+  putColumn(out_, chunkDocument_);
+  putColumn(out_, textOffsets_);
+  putLittleEndian(out_, footerOffset);
+  out_.write(MAGIC, 8);
+}
+
+} // namespace guardian
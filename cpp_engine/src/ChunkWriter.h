@@ -0,0 +1,89 @@
+#ifndef CHUNK_WRITER_H
+#define CHUNK_WRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * ChunkWriter - Serializes the chunks of a sequence of documents
+ */
+class ChunkWriter {
+public:
+  virtual ~ChunkWriter() = default;
+
+  /**
+   * Append the chunks of one document
+   */
+  virtual void write(const std::string &source,
+                     const std::vector<std::string> &chunks) = 0;
+
+  /**
+   * Complete the output; nothing may be written after
+   */
+  virtual void finish() {}
+};
+
+/**
+ * NdjsonWriter - One JSON object per chunk and line:
+ *
+ *   {"source":"dir/name.pdf","chunk":0,"text":"..."}
+ */
+class NdjsonWriter : public ChunkWriter {
+public:
+  explicit NdjsonWriter(std::ostream &out) : out_(out) {}
+
+  void write(const std::string &source,
+             const std::vector<std::string> &chunks) override;
+
+private:
+  std::ostream &out_;
+  std::string line_;
+};
+
+/**
+ * ColumnarWriter - Chunks as columns of one binary file
+ *
+ * Chunk texts are streamed to the file back to back as they are written,
+ * and the other columns follow in a footer once the output is finished,
+ * so a reader can map the file and slice texts without parsing:
+ *
+ *   "GDCHUNK1"
+ *   text column        UTF-8 chunk texts, back to back
+ *   u64 documents, u64 chunks
+ *   u64 sourceOffsets[documents + 1]   into the source names below
+ *   source names       back to back
+ *   u32 chunkDocument[chunks]          document of each chunk
+ *   u64 textOffsets[chunks + 1]        into the text column
+ *   u64 footerOffset                   file offset of "u64 documents"
+ *   "GDCHUNK1"
+ *
+ * Integers are little-endian; text offsets are relative to the start of
+ * the text column (file offset 8).
+ */
+class ColumnarWriter : public ChunkWriter {
+public:
+  static constexpr char MAGIC[9] = "GDCHUNK1";
+
+  explicit ColumnarWriter(std::ostream &out);
+
+  void write(const std::string &source,
+             const std::vector<std::string> &chunks) override;
+
+  void finish() override;
+
+private:
+  std::ostream &out_;
+  std::vector<uint64_t> sourceOffsets_{0};
+  std::string sources_;
+  std::vector<uint32_t> chunkDocument_;
+  std::vector<uint64_t> textOffsets_{0};
+  bool finished_ = false;
+};
+
+} // namespace guardian
+
+#endif // CHUNK_WRITER_H
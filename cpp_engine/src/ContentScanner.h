@@ -0,0 +1,117 @@
+#ifndef CONTENT_SCANNER_H
+#define CONTENT_SCANNER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * Finding - A single sensitive-content match
+ */
+struct Finding {
+  std::string rule;     // Rule name, e.g. "email"
+  std::string category; // "credential", "api_key", "email", ...
+  size_t offset;        // Byte offset in the scanned text
+  size_t length;        // Byte length of the match
+  int chunkIndex = -1;  // Owning chunk, when produced by the chunker
+};
+
+/**
+ * ContentScanner - Multi-pattern PII and secret detection
+ *
+ * Literal keywords are matched together by a single Aho-Corasick automaton
+ * (ASCII case-insensitive). Structured patterns use a small regex subset:
+ *
+ *   literals, '.', [a-z0-9_-], [^...], \d \w \s, \. escapes,
+ *   quantifiers ? * + {n} {n,} {n,m}, and \b at either end.
+ *
+ * There is no alternation or grouping; that keeps every rule a linear NFA
+ * of at most 64 positions, one bit each. Each rule's NFA is simulated
+ * over the text once, with every start position in flight at the same
+ * time, so a scan is one Aho-Corasick pass plus one pass per structured
+ * rule, each linear in the text for any input.
+ */
+class ContentScanner {
+public:
+  enum class Validator { None, Luhn };
+
+  /**
+   * Constructor
+   * @param loadDefaults Register the built-in credential/PII rule set
+   */
+  explicit ContentScanner(bool loadDefaults = true);
+
+  /**
+   * Add a case-insensitive literal keyword
+   */
+  void addLiteral(const std::string &rule, const std::string &category,
+                  const std::string &literal);
+
+  /**
+   * Add a structured pattern
+   * @throws std::invalid_argument if the pattern is outside the subset
+   */
+  void addPattern(const std::string &rule, const std::string &category,
+                  const std::string &pattern,
+                  Validator validator = Validator::None);
+
+  /**
+   * Scan text for all rules
+   * @return Findings ordered by offset
+   */
+  std::vector<Finding> scan(const std::string &text) const;
+
+  /**
+   * Mask the non-whitespace bytes covered by findings, preserving length
+   * and word boundaries so the redacted text tokenizes identically.
+   */
+  static std::string redact(const std::string &text,
+                            const std::vector<Finding> &findings,
+                            char mask = '*');
+
+  size_t ruleCount() const { return literals_.size() + patterns_.size(); }
+
+private:
+  struct Literal {
+    std::string rule;
+    std::string category;
+    size_t length;
+  };
+
+  // Position i of the NFA is bit i; bit slotCount accepts
+  struct Pattern {
+    std::string rule;
+    std::string category;
+    Validator validator;
+    bool boundaryStart;
+    bool boundaryEnd;
+    int slotCount;
+    uint64_t entry;                    // Positions before the first byte
+    uint64_t loops;                    // Star positions: stay on a match
+    uint64_t skippable;                // Optional and star positions
+    std::array<uint64_t, 256> follows; // Positions consuming each byte
+  };
+
+  // Aho-Corasick automaton over literal byte classes
+  std::vector<Literal> literals_;
+  std::vector<std::string> literalText_;
+  int acClassCount_ = 1;
+  std::array<uint8_t, 256> acByteClass_{};
+  std::vector<int32_t> acTransitions_;
+  std::vector<std::vector<int>> acOutputs_;
+
+  std::vector<Pattern> patterns_;
+
+  void buildAutomaton();
+  void scanLiterals(const std::string &text,
+                    std::vector<Finding> &findings) const;
+  void scanPattern(const Pattern &pattern, const std::string &text,
+                   std::vector<Finding> &findings) const;
+};
+
+} // namespace guardian
+
+#endif // CONTENT_SCANNER_H
@@ -0,0 +1,214 @@
+#include "DirectoryWatcher.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace guardian {
+
+bool DirectoryWatcher::wanted(const std::string &name) const {
+  if (name.empty() || name[0] == '.') {
+    return false; // Hidden, or a temporary name about to be renamed
+  }
+  const std::string &suffix = options_.suffix;
+  if (name.size() < suffix.size()) {
+    return false;
+  }
+  return std::equal(suffix.begin(), suffix.end(),
+                    name.end() - static_cast<ptrdiff_t>(suffix.size()),
+                    [](char a, char b) {
+                      return std::tolower(static_cast<unsigned char>(a)) ==
+                             std::tolower(static_cast<unsigned char>(b));
+                    });
+}
+
+DirectoryWatcher::Clock::duration
+DirectoryWatcher::settle(const Pending &pending) const {
+  return std::chrono::milliseconds(pending.closed ? options_.settleMs
+                                                  : options_.openSettleMs);
+}
+
+void DirectoryWatcher::touch(const std::string &path, bool closed) {
+  Pending &pending = pending_[path];
+  pending.last = Clock::now();
+  pending.closed = closed;
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE |
+                                IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE |
+                                IN_ONLYDIR;
+
+} // namespace
+
+DirectoryWatcher::DirectoryWatcher(const WatchOptions &options)
+    : options_(options) {
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ < 0) {
+    throw std::runtime_error("Failed to initialize inotify");
+  }
+}
+
+DirectoryWatcher::~DirectoryWatcher() { ::close(fd_); }
+
+void DirectoryWatcher::watch(const std::string &directory) {
+  int wd = inotify_add_watch(fd_, directory.c_str(), WATCH_MASK);
+  if (wd < 0) {
+    throw std::runtime_error("Failed to watch directory: " + directory);
+  }
+  if (directories_.emplace(wd, directory).second) {
+    ++stats_.directories;
+  }
+  // Files written before the watch was in place have no events
+  scan(directory);
+}
+
+void DirectoryWatcher::scan(const std::string &directory) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  for (fs::directory_iterator it(directory, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    std::string name = it->path().filename().string();
+    if (it->is_directory(ec)) {
+      if (options_.recursive && !name.empty() && name[0] != '.') {
+        try {
+          watch(it->path().string());
+        } catch (const std::runtime_error &) {
+          // Removed meanwhile, or unreadable: skip it
+        }
+      }
+    } else if (wanted(name)) {
+      touch(it->path().string(), true);
+    }
+  }
+}
+
+void DirectoryWatcher::readEvents() {
+  alignas(inotify_event) char buffer[64 * 1024];
+
+  for (;;) {
+    ssize_t length = read(fd_, buffer, sizeof(buffer));
+    if (length <= 0) {
+      return; // EAGAIN: drained
+    }
+
+    for (char *p = buffer; p < buffer + length;) {
+      const auto *event = reinterpret_cast<const inotify_event *>(p);
+      p += sizeof(inotify_event) + event->len;
+      ++stats_.events;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Events were lost: look at everything again
+        ++stats_.overflows;
+        std::vector<std::string> watched;
+        for (const auto &entry : directories_)
+          watched.push_back(entry.second);
+        for (const auto &directory : watched)
+          scan(directory);
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        directories_.erase(event->wd); // Directory removed
+        continue;
+      }
+      auto it = directories_.find(event->wd);
+      if (it == directories_.end() || event->len == 0) {
+        continue;
+      }
+
+      std::string name(event->name);
+      std::string path = it->second + "/" + name;
+      if (event->mask & IN_ISDIR) {
+        if (options_.recursive && (event->mask & (IN_CREATE | IN_MOVED_TO)) &&
+            name[0] != '.') {
+          try {
+            watch(path);
+          } catch (const std::runtime_error &) {
+          }
+        }
+      } else if (!wanted(name)) {
+        continue;
+      } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        pending_.erase(path);
+      } else {
+        touch(path, event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO));
+      }
+    }
+  }
+}
+
+std::vector<std::string> DirectoryWatcher::poll(int timeoutMs) {
+  std::vector<std::string> ready;
+  Clock::time_point deadline =
+      Clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0));
+
+  for (;;) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point wake = deadline;
+    for (auto it = pending_.begin(); it != pending_.end();) {
+      Clock::time_point due = it->second.last + settle(it->second);
+      if (due > now) {
+        wake = std::min(wake, due);
+        ++it;
+        continue;
+      }
+      // Quiet long enough; empty files wait for their next write
+      struct stat info;
+      if (stat(it->first.c_str(), &info) == 0 && S_ISREG(info.st_mode) &&
+          info.st_size > 0) {
+        ready.push_back(it->first);
+      }
+      it = pending_.erase(it);
+    }
+    if (!ready.empty() || now >= deadline) {
+      break;
+    }
+
+    auto wait =
+        std::chrono::ceil<std::chrono::milliseconds>(wake - now).count();
+    pollfd fds{fd_, POLLIN, 0};
+    int polled = ::poll(&fds, 1, static_cast<int>(wait));
+    if (polled < 0 && errno == EINTR) {
+      break;
+    }
+    if (polled > 0) {
+      readEvents();
+    }
+  }
+
+  std::sort(ready.begin(), ready.end());
+  stats_.files += ready.size();
+  return ready;
+}
+
+#else
+
+DirectoryWatcher::DirectoryWatcher(const WatchOptions &options)
+    : options_(options) {
+  throw std::runtime_error("Directory watching requires inotify");
+}
+
+DirectoryWatcher::~DirectoryWatcher() = default;
+
+void DirectoryWatcher::watch(const std::string &) {}
+
+void DirectoryWatcher::scan(const std::string &) {}
+
+void DirectoryWatcher::readEvents() {}
+
+std::vector<std::string> DirectoryWatcher::poll(int) { return {}; }
+
+#endif
+
+} // namespace guardian
@@ -0,0 +1,93 @@
+#ifndef DIRECTORY_WATCHER_H
+#define DIRECTORY_WATCHER_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * WatchOptions - Which files a DirectoryWatcher reports, and when
+ */
+struct WatchOptions {
+  std::string suffix = ".pdf"; // Case-insensitive; empty = every file
+  bool recursive = false;      // Also watch subdirectories, new ones too
+  int settleMs = 500;          // Quiet period after the writer closed
+  int openSettleMs = 5000;     // Quiet period while still open for writing
+};
+
+/**
+ * DirectoryWatcher - Reports files once they are completely written
+ *
+ * Directories are watched with inotify. A file becomes pending when it
+ * is created, written, or moved into a watched directory, and is
+ * reported once it has been quiet for settleMs after its writer closed
+ * it (or it was renamed into place), and still exists and is not empty.
+ * Writers that keep a file open and pause are covered by the longer
+ * openSettleMs. Files starting with '.' are ignored, so writing to a
+ * hidden temporary name and renaming it is always safe.
+ *
+ * Files already present when a directory is watched are reported too;
+ * after an event queue overflow every watched directory is rescanned,
+ * so callers should skip files they have already processed.
+ */
+class DirectoryWatcher {
+public:
+  /**
+   * @throws std::runtime_error if inotify is unavailable
+   */
+  explicit DirectoryWatcher(const WatchOptions &options = WatchOptions());
+  ~DirectoryWatcher();
+
+  DirectoryWatcher(const DirectoryWatcher &) = delete;
+  DirectoryWatcher &operator=(const DirectoryWatcher &) = delete;
+
+  /**
+   * Start watching a directory
+   * @throws std::runtime_error if it cannot be watched
+   */
+  void watch(const std::string &directory);
+
+  /**
+   * Wait up to timeoutMs for files to finish being written
+   * @return Completed files, possibly none (also when interrupted by a
+   *         signal)
+   */
+  std::vector<std::string> poll(int timeoutMs);
+
+  struct Stats {
+    size_t events;      // inotify events read
+    size_t files;       // Files reported
+    size_t directories; // Directories watched
+    size_t overflows;   // Event queue overflows (rescans)
+  };
+
+  Stats getStats() const { return stats_; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Pending {
+    Clock::time_point last; // Latest event
+    bool closed = false;    // Writer closed it since
+  };
+
+  WatchOptions options_;
+  int fd_ = -1;
+  std::unordered_map<int, std::string> directories_; // By watch descriptor
+  std::unordered_map<std::string, Pending> pending_;
+  Stats stats_{};
+
+  void scan(const std::string &directory);
+  void touch(const std::string &path, bool closed);
+  bool wanted(const std::string &name) const;
+  void readEvents();
+  Clock::duration settle(const Pending &pending) const;
+};
+
+} // namespace guardian
+
+#endif // DIRECTORY_WATCHER_H
@@ -0,0 +1,94 @@
+#include "IoService.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace guardian {
+
+IoService::IoService(unsigned threads, ThreadPool &pool) : pool_(pool) {
+  threads = std::max(threads, 1u);
+  for (unsigned i = 0; i < threads; ++i)
+    threads_.emplace_back(&IoService::readerLoop, this);
+}
+
+IoService::~IoService() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  for (auto &thread : threads_)
+    thread.join();
+}
+
+IoService &IoService::instance() {
+  static IoService service;
+  return service;
+}
+
+std::vector<char> IoService::readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("Failed to open PDF: " + path);
+  }
+
+  // A directory opens too, reporting -1 or a bogus size
+  std::error_code ec;
+  std::streamoff size = in.tellg();
+  if (size < 0 || std::filesystem::is_directory(path, ec)) {
+    throw std::runtime_error("Failed to read PDF: " + path);
+  }
+
+  std::vector<char> data(static_cast<size_t>(size));
+  in.seekg(0);
+  if (!in.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+    throw std::runtime_error("Failed to read PDF: " + path);
+  }
+  return data;
+}
+
+void IoService::submit(Read *request) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(request);
+  }
+  ready_.notify_one();
+}
+
+void IoService::readerLoop() {
+  for (;;) {
+    Read *request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+      if (requests_.empty()) {
+        return; // Stopping and drained
+      }
+      request = requests_.front();
+      requests_.pop_front();
+    }
+
+    try {
+      request->data_ = readFile(request->path_);
+    } catch (...) {
+      request->error_ = std::current_exception();
+    }
+    std::coroutine_handle<> handle = request->handle_;
+    pool_.post([handle]() { handle.resume(); });
+  }
+}
+
+void IoService::Read::await_suspend(std::coroutine_handle<> handle) {
+  handle_ = handle;
+  service_.submit(this);
+}
+
+std::vector<char> IoService::Read::await_resume() {
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  return std::move(data_);
+}
+
+} // namespace guardian
@@ -0,0 +1,86 @@
+#ifndef IO_SERVICE_H
+#define IO_SERVICE_H
+
+#include "ThreadPool.h"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * IoService - File reads for coroutines, off the worker pool
+ *
+ * A coroutine awaiting read() suspends while one of the service's reader
+ * threads loads the file, and is resumed on the ThreadPool with the
+ * contents. Pool workers therefore never block on the disk, and a small
+ * pool keeps many documents in flight.
+ */
+class IoService {
+public:
+  explicit IoService(unsigned threads = 2,
+                     ThreadPool &pool = ThreadPool::instance());
+  ~IoService();
+
+  IoService(const IoService &) = delete;
+  IoService &operator=(const IoService &) = delete;
+
+  /**
+   * The shared service, started on first use
+   */
+  static IoService &instance();
+
+  /**
+   * Awaitable read of a whole file
+   *
+   *   std::vector<char> data = co_await io.read(path);
+   *
+   * @throws std::runtime_error (from co_await) if the file cannot be read
+   */
+  class Read {
+  public:
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    std::vector<char> await_resume();
+
+  private:
+    friend class IoService;
+
+    Read(IoService &service, std::string path)
+        : service_(service), path_(std::move(path)) {}
+
+    IoService &service_;
+    std::string path_;
+    std::vector<char> data_;
+    std::exception_ptr error_;
+    std::coroutine_handle<> handle_;
+  };
+
+  Read read(std::string path) { return Read(*this, std::move(path)); }
+
+  /**
+   * Load a whole file on the calling thread
+   * @throws std::runtime_error if the file cannot be opened or read
+   */
+  static std::vector<char> readFile(const std::string &path);
+
+private:
+  ThreadPool &pool_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<Read *> requests_;
+  bool stopping_ = false;
+
+  void submit(Read *request);
+  void readerLoop();
+};
+
+} // namespace guardian
+
+#endif // IO_SERVICE_H
@@ -0,0 +1,88 @@
+#include "MappedFile.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if __has_include(<sys/mman.h>)
+#define GUARDIAN_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include "IoService.h"
+#endif
+
+namespace guardian {
+
+#ifdef GUARDIAN_MMAP
+
+MappedFile::MappedFile(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open PDF: " + path);
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Failed to read PDF: " + path);
+  }
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ == 0) {
+    ::close(fd);
+    return; // Nothing to map; data() stays null
+  }
+
+  void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps the file open
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("Failed to map PDF: " + path);
+  }
+  data_ = static_cast<const char *>(addr);
+  mapped_ = true;
+  madvise(addr, size_, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() {
+  if (mapped_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+size_t MappedFile::advise(size_t offset, size_t length, int advice) {
+  if (!mapped_ || offset >= size_ || length == 0) {
+    return 0;
+  }
+  // madvise takes page-aligned addresses; widen the range to whole pages
+  static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t end = offset + std::min(length, size_ - offset);
+  size_t begin = offset - offset % page;
+  madvise(const_cast<char *>(data_) + begin, end - begin, advice);
+  return end - offset;
+}
+
+void MappedFile::willNeed(size_t offset, size_t length) {
+  stats_.prefetchedBytes += advise(offset, length, MADV_WILLNEED);
+}
+
+void MappedFile::release(size_t offset, size_t length) {
+  stats_.releasedBytes += advise(offset, length, MADV_DONTNEED);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path)
+    : copy_(IoService::readFile(path)) {
+  data_ = copy_.data();
+  size_ = copy_.size();
+}
+
+MappedFile::~MappedFile() = default;
+
+void MappedFile::willNeed(size_t, size_t) {}
+
+void MappedFile::release(size_t, size_t) {}
+
+#endif
+
+} // namespace guardian
@@ -0,0 +1,68 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * MappedFile - Read-only memory mapping of a whole file
+ *
+ * The file is mapped with MADV_SEQUENTIAL, so the kernel reads ahead
+ * aggressively and reclaims pages behind the reader early. Readers that
+ * know where they are going next can say so: willNeed() starts reading a
+ * range in the background, and release() drops a range already parsed
+ * from resident memory (it is faulted in again from the file if touched),
+ * keeping the resident size of a large document bounded by the window
+ * between the two.
+ *
+ * Where mmap is unavailable the file is read into memory and the hints
+ * do nothing.
+ */
+class MappedFile {
+public:
+  /**
+   * @throws std::runtime_error if the file cannot be opened or mapped
+   */
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /**
+   * Start reading [offset, offset + length) ahead of its use
+   */
+  void willNeed(size_t offset, size_t length);
+
+  /**
+   * Drop [offset, offset + length) from resident memory
+   */
+  void release(size_t offset, size_t length);
+
+  struct Stats {
+    size_t prefetchedBytes; // Requested through willNeed
+    size_t releasedBytes;   // Dropped through release
+  };
+
+  Stats getStats() const { return stats_; }
+
+private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<char> copy_; // Without mmap
+  Stats stats_{};
+
+  // Returns the bytes of the range inside the mapping
+  size_t advise(size_t offset, size_t length, int advice);
+};
+
+} // namespace guardian
+
+#endif // MAPPED_FILE_H
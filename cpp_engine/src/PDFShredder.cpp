@@ -1,21 +1,130 @@
 #include "PDFShredder.h"
+#include "IoService.h"
+#include "MappedFile.h"
+#include "XYCut.h"
 #include <poppler/cpp/poppler-document.h>
 #include <poppler/cpp/poppler-page.h>
+#include <poppler/cpp/poppler-toc.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace guardian {
 
+namespace {
+
+// Bytes of a mapped file prefetched ahead of, and kept behind, the
+// estimated position of the page being extracted
+constexpr size_t MAP_WINDOW = 8 * 1024 * 1024;
+
+} // namespace
+
 // Pimpl implementation
 class PDFShredder::Impl {
 public:
   int pageCount = 0;
+  ResourceGuard guard;
+  TextNormalizer normalizer;
+  Utf8Validator utf8;
+  bool normalize = true;
+  bool readingOrder = true;
+  XYCut xycut;
+  SectionDetector sections;
+  TableDetector tableDetector;
+  bool detectTables = true;
+  bool memoryMapping = false;
+  std::unique_ptr<MappedFile> mapped; // Outlives the document reading it
+  size_t prefetchedTo = 0;            // Mapping offsets advised so far
+  size_t releasedTo = 0;
+
+  // Scratch state reused across pages
+  PageLayout scratch;
+  std::unordered_map<std::string, uint16_t> fontIds; // Into layout fonts
+  std::string word;
+
+  explicit Impl(const ResourceLimits &limits) : guard(limits) {}
+
+  std::unique_ptr<poppler::document> open(const std::string &filepath) {
+    mapped.reset();
+    if (!memoryMapping) {
+      return load(IoService::readFile(filepath), filepath);
+    }
 
-  std::vector<std::string> extract(const std::string &filepath) {
-    // Load PDF document
-    std::unique_ptr<poppler::document> doc(
-        poppler::document::load_from_file(filepath));
+    mapped = std::make_unique<MappedFile>(filepath);
+    std::unique_ptr<poppler::document> doc =
+        loadRaw(mapped->data(), mapped->size(), filepath);
+    // The pre-flight scan touched every page of the file; poppler needs
+    // only the cross-reference table and the objects of each page
+    mapped->release(0, mapped->size());
+    prefetchedTo = releasedTo = 0;
+    return doc;
+  }
 
+  // poppler-cpp does not expose where a page's content streams are, so
+  // page i of n is assumed to sit at i/n of the file: prefetch a window
+  // ahead of that, and drop what lies more than a window behind it
+  void advance(int i) {
+    if (!mapped || pageCount == 0) {
+      return;
+    }
+    size_t size = mapped->size();
+    size_t pos =
+        static_cast<size_t>(static_cast<double>(size) * i / pageCount);
+    size_t ahead = std::min(size, pos + MAP_WINDOW);
+    if (ahead > prefetchedTo) {
+      size_t from = std::max(pos, prefetchedTo);
+      mapped->willNeed(from, ahead - from);
+      prefetchedTo = ahead;
+    }
+    if (pos > releasedTo + MAP_WINDOW) {
+      mapped->release(releasedTo, pos - MAP_WINDOW - releasedTo);
+      releasedTo = pos - MAP_WINDOW;
+    }
+  }
+
+  // Unmap once the document reading from the mapping is gone
+  void close(std::unique_ptr<poppler::document> &doc) {
+    doc.reset();
+    mapped.reset();
+  }
+
+  std::unique_ptr<poppler::document> load(poppler::byte_array data,
+                                          const std::string &filepath) {
+    prepare(data.data(), data.size());
+
+    // Load PDF document (poppler takes over the buffer)
+    return checked(poppler::document::load_from_data(&data), filepath);
+  }
+
+  // The document reads from data, which must outlive it
+  std::unique_ptr<poppler::document>
+  loadRaw(const char *data, size_t size,
+          const std::string &filepath = "<memory>") {
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+      throw std::runtime_error("PDF too large to load from memory: " +
+                               filepath);
+    }
+    prepare(data, size);
+    return checked(
+        poppler::document::load_from_raw_data(data, static_cast<int>(size)),
+        filepath);
+  }
+
+  void prepare(const char *data, size_t size) {
+    pageCount = 0;
+    normalizer.resetStats();
+    utf8.resetStats();
+
+    // Pre-flight scan: reject decompression bombs before poppler sees them
+    guard.scan(data, size);
+  }
+
+  std::unique_ptr<poppler::document> checked(poppler::document *loaded,
+                                             const std::string &filepath) {
+    std::unique_ptr<poppler::document> doc(loaded);
     if (!doc) {
       throw std::runtime_error("Failed to open PDF: " + filepath);
     }
@@ -25,33 +134,279 @@ public:
     }
 
     pageCount = doc->pages();
+    return doc;
+  }
+
+  std::vector<std::string> extract(std::unique_ptr<poppler::document> doc) {
     std::vector<std::string> pages;
-    pages.reserve(pageCount);
+    stream(std::move(doc), [&pages](int, std::string &text) {
+      pages.push_back(std::move(text));
+    });
+    return pages;
+  }
+
+  // Extract text from each page into one reused buffer
+  void stream(std::unique_ptr<poppler::document> doc,
+              const PageCallback &onPage) {
+    std::string text;
 
-    // Extract text from each page
     for (int i = 0; i < pageCount; ++i) {
+      advance(i);
       std::unique_ptr<poppler::page> page(doc->create_page(i));
+      text.clear();
       if (!page) {
-        pages.push_back(""); // Empty page
+        onPage(i, text); // Empty page
         continue;
       }
 
-      poppler::byte_array text = page->text().to_utf8();
-      pages.push_back(std::string(text.data(), text.size()));
+      if (readingOrder) {
+        // Word boxes reordered by XY-cut instead of poppler's physical
+        // layout, which interleaves the lines of side-by-side columns
+        readWords(*page, i, scratch, nullptr);
+        text = XYCut::text(scratch, xycut.order(scratch));
+      } else {
+        poppler::byte_array bytes = page->text().to_utf8();
+        guard.checkPageText(i, bytes.size());
+        text.assign(bytes.data(), bytes.size());
+      }
+      utf8.repair(text);
+      if (normalize) {
+        normalizer.normalize(text);
+      }
+      onPage(i, text);
     }
+    close(doc);
+  }
 
-    return pages;
+  StructuredText extractStructured(const std::string &filepath) {
+    std::unique_ptr<poppler::document> doc = open(filepath);
+    StructuredText result;
+    result.pages.reserve(pageCount);
+    sections.reset(readOutline(*doc));
+    DocumentLayout fonts; // Font table only; pages go through scratch
+    fontIds.clear();
+
+    for (int i = 0; i < pageCount; ++i) {
+      advance(i);
+      std::unique_ptr<poppler::page> page(doc->create_page(i));
+      if (!page) {
+        result.pages.push_back(""); // Empty page
+        continue;
+      }
+
+      // Tables leave the text flow, with an anchor word in their place
+      readWords(*page, i, scratch, &fonts);
+      std::vector<Table> tables;
+      if (detectTables) {
+        tables = tableDetector.detect(scratch);
+        TableDetector::addAnchors(scratch, tables);
+      }
+
+      // Headings are detected on the words in reading order, before the
+      // text is rendered, so they come out as paragraphs of their own
+      ReadingOrder order = xycut.order(scratch);
+      sections.detectPage(scratch, fonts.fonts, order);
+      result.pages.push_back(XYCut::text(scratch, order));
+
+      std::string &text = result.pages.back();
+      utf8.repair(text);
+      if (normalize) {
+        normalizer.normalize(text);
+      }
+      TableDetector::takeAnchors(text, tables);
+      sections.locatePage(text);
+
+      std::sort(tables.begin(), tables.end(),
+                [](const Table &a, const Table &b) {
+                  return a.offset < b.offset;
+                });
+      std::move(tables.begin(), tables.end(),
+                std::back_inserter(result.tables));
+    }
+
+    close(doc);
+    result.headings = sections.finish();
+    return result;
+  }
+
+  DocumentLayout extractLayout(const std::string &filepath) {
+    std::unique_ptr<poppler::document> doc = open(filepath);
+    DocumentLayout layout;
+    layout.pages.resize(pageCount);
+    fontIds.clear();
+
+    for (int i = 0; i < pageCount; ++i) {
+      layout.pages[i].pageIndex = i;
+      advance(i);
+      std::unique_ptr<poppler::page> page(doc->create_page(i));
+      if (page) {
+        readWords(*page, i, layout.pages[i], &layout);
+      }
+    }
+
+    close(doc);
+    return layout;
+  }
+
+  // Flatten the bookmark tree in document order
+  std::vector<OutlineEntry> readOutline(poppler::document &doc) {
+    std::vector<OutlineEntry> outline;
+    std::unique_ptr<poppler::toc> toc(doc.create_toc());
+    if (!toc || !toc->root()) {
+      return outline;
+    }
+
+    constexpr int MAX_DEPTH = 16;
+    std::vector<std::pair<poppler::toc_item *, int>> stack;
+    auto pushChildren = [&stack](poppler::toc_item *item, int level) {
+      std::vector<poppler::toc_item *> children = item->children();
+      for (auto it = children.rbegin(); it != children.rend(); ++it)
+        stack.emplace_back(*it, level);
+    };
+
+    pushChildren(toc->root(), 1);
+    while (!stack.empty()) {
+      auto [item, level] = stack.back();
+      stack.pop_back();
+      poppler::byte_array title = item->title().to_utf8();
+      outline.push_back({level, std::string(title.data(), title.size())});
+      if (level < MAX_DEPTH) {
+        pushChildren(item, level + 1);
+      }
+    }
+    return outline;
+  }
+
+  // Fill a PageLayout from poppler's word list. Font names are resolved
+  // (and requested from poppler) only when a document layout is given.
+  void readWords(poppler::page &page, int i, PageLayout &out,
+                 DocumentLayout *layout) {
+    out.clear();
+    out.pageIndex = i;
+    poppler::rectf rect = page.page_rect();
+    out.width = static_cast<float>(rect.width());
+    out.height = static_cast<float>(rect.height());
+
+    std::vector<poppler::text_box> boxes =
+        layout ? page.text_list(poppler::page::text_list_include_font)
+               : page.text_list();
+    out.reserve(boxes.size());
+
+    for (const poppler::text_box &box : boxes) {
+      poppler::byte_array bytes = box.text().to_utf8();
+      word.assign(bytes.data(), bytes.size());
+      utf8.repair(word);
+
+      uint16_t fontId = PageLayout::NO_FONT;
+      float fontSize = 0;
+      if (layout && box.has_font_info()) {
+        fontSize = static_cast<float>(box.get_font_size());
+        auto it = fontIds.find(box.get_font_name());
+        if (it != fontIds.end()) {
+          fontId = it->second;
+        } else if (layout->fonts.size() < PageLayout::NO_FONT) {
+          fontId = static_cast<uint16_t>(layout->fonts.size());
+          layout->fonts.push_back(box.get_font_name());
+          fontIds.emplace(layout->fonts.back(), fontId);
+        }
+      }
+
+      uint8_t flags = static_cast<uint8_t>((box.rotation() & 3)
+                                           << PageLayout::ROTATION_SHIFT);
+      if (box.has_space_after()) {
+        flags |= PageLayout::SPACE_AFTER;
+      }
+
+      poppler::rectf r = box.bbox();
+      out.addWord(word.data(), word.size(), static_cast<float>(r.left()),
+                  static_cast<float>(r.top()), static_cast<float>(r.right()),
+                  static_cast<float>(r.bottom()), fontSize, fontId, flags);
+      guard.checkPageText(i, out.text.size());
+    }
   }
 };
 
-PDFShredder::PDFShredder() : pImpl(std::make_unique<Impl>()) {}
+PDFShredder::PDFShredder()
+    : pImpl(std::make_unique<Impl>(ResourceLimits())) {}
+
+PDFShredder::PDFShredder(const ResourceLimits &limits)
+    : pImpl(std::make_unique<Impl>(limits)) {}
 
 PDFShredder::~PDFShredder() = default;
 
 std::vector<std::string> PDFShredder::extractText(const std::string &filepath) {
-  return pImpl->extract(filepath);
+  return pImpl->extract(pImpl->open(filepath));
+}
+
+void PDFShredder::streamText(const std::string &filepath,
+                             const PageCallback &onPage) {
+  pImpl->stream(pImpl->open(filepath), onPage);
+}
+
+std::vector<std::string>
+PDFShredder::extractTextFromMemory(std::vector<char> data) {
+  return pImpl->extract(pImpl->load(std::move(data), "<memory>"));
+}
+
+std::vector<std::string> PDFShredder::extractTextFromMemory(const char *data,
+                                                            size_t size) {
+  return pImpl->extract(pImpl->loadRaw(data, size));
+}
+
+StructuredText PDFShredder::extractStructured(const std::string &filepath) {
+  return pImpl->extractStructured(filepath);
+}
+
+DocumentLayout PDFShredder::extractLayout(const std::string &filepath) {
+  return pImpl->extractLayout(filepath);
 }
 
 int PDFShredder::getPageCount() const { return pImpl->pageCount; }
 
+void PDFShredder::setLimits(const ResourceLimits &limits) {
+  pImpl->guard = ResourceGuard(limits);
+}
+
+ResourceLimits PDFShredder::getLimits() const {
+  return pImpl->guard.getLimits();
+}
+
+ResourceGuard::Stats PDFShredder::getScanStats() const {
+  return pImpl->guard.getStats();
+}
+
+void PDFShredder::setReadingOrder(bool enabled) {
+  pImpl->readingOrder = enabled;
+}
+
+void PDFShredder::setSectionOptions(const SectionOptions &options) {
+  pImpl->sections = SectionDetector(options);
+}
+
+void PDFShredder::setTableDetection(bool enabled) {
+  pImpl->detectTables = enabled;
+}
+
+void PDFShredder::setTableOptions(const TableOptions &options) {
+  pImpl->tableDetector = TableDetector(options);
+}
+
+void PDFShredder::setMemoryMapping(bool enabled) {
+  pImpl->memoryMapping = enabled;
+}
+
+void PDFShredder::setNormalize(bool enabled) { pImpl->normalize = enabled; }
+
+void PDFShredder::setNormalizeOptions(const NormalizeOptions &options) {
+  pImpl->normalizer = TextNormalizer(options);
+}
+
+TextNormalizer::Stats PDFShredder::getNormalizeStats() const {
+  return pImpl->normalizer.getStats();
+}
+
+Utf8Validator::Stats PDFShredder::getUtf8Stats() const {
+  return pImpl->utf8.getStats();
+}
+
 } // namespace guardian
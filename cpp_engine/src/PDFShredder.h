@@ -1,6 +1,13 @@
 #ifndef PDF_SHREDDER_H
 #define PDF_SHREDDER_H
 
+#include "PageLayout.h"
+#include "ResourceGuard.h"
+#include "SectionDetector.h"
+#include "TableDetector.h"
+#include "TextNormalizer.h"
+#include "Utf8Validator.h"
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -15,7 +22,10 @@ namespace guardian {
  */
 class PDFShredder {
 public:
+    using PageCallback = std::function<void(int page, std::string& text)>;
+
     PDFShredder();
+    explicit PDFShredder(const ResourceLimits& limits);
     ~PDFShredder();
     
     /**
@@ -23,14 +33,130 @@ public:
      * @param filepath Absolute path to PDF file
      * @return Vector of text strings (one per page)
      * @throws std::runtime_error if file cannot be opened or parsed
+     * @throws ResourceLimitError if the document exceeds a resource limit
      */
     std::vector<std::string> extractText(const std::string& filepath);
     
+    /**
+     * Extract text page by page, without keeping earlier pages
+     * @param filepath Absolute path to PDF file
+     * @param onPage Called with each page index and its text; the text
+     *        buffer is reused for the next page (it may be moved from)
+     * @throws std::runtime_error if file cannot be opened or parsed
+     * @throws ResourceLimitError if the document exceeds a resource limit
+     */
+    void streamText(const std::string& filepath, const PageCallback& onPage);
+    
+    /**
+     * Extract all text content from a PDF already in memory (e.g. read
+     * asynchronously); the buffer is handed to poppler without a copy
+     * @param data Complete PDF file contents
+     * @return Vector of text strings (one per page)
+     * @throws std::runtime_error if the data cannot be parsed
+     * @throws ResourceLimitError if the document exceeds a resource limit
+     */
+    std::vector<std::string> extractTextFromMemory(std::vector<char> data);
+    
+    /**
+     * Extract all text content from a PDF in caller-owned memory, read in
+     * place (the data must stay valid until the call returns)
+     * @throws std::runtime_error if the data cannot be parsed
+     * @throws ResourceLimitError if the document exceeds a resource limit
+     */
+    std::vector<std::string> extractTextFromMemory(const char* data,
+                                                   size_t size);
+    
+    /**
+     * Extract page text in reading order together with section headings,
+     * detected from font statistics and the PDF outline in the same pass,
+     * and with tables taken out as separate chunks
+     * @param filepath Absolute path to PDF file
+     * @return Page texts, headings and tables with offsets into them
+     * @throws std::runtime_error if file cannot be opened or parsed
+     * @throws ResourceLimitError if the document exceeds a resource limit
+     */
+    StructuredText extractStructured(const std::string& filepath);
+    
+    /**
+     * Extract words with bounding boxes and font attributes
+     * @param filepath Absolute path to PDF file
+     * @return Columnar per-page layouts (words are not normalized)
+     * @throws std::runtime_error if file cannot be opened or parsed
+     * @throws ResourceLimitError if the document exceeds a resource limit
+     */
+    DocumentLayout extractLayout(const std::string& filepath);
+    
     /**
      * Get the number of pages in the last processed PDF
      */
     int getPageCount() const;
     
+    /**
+     * Replace the resource limits applied to subsequent extractions
+     */
+    void setLimits(const ResourceLimits& limits);
+    
+    /**
+     * Get the resource limits currently in effect
+     */
+    ResourceLimits getLimits() const;
+    
+    /**
+     * Get pre-flight scan statistics for the last processed PDF
+     */
+    ResourceGuard::Stats getScanStats() const;
+    
+    /**
+     * Order extracted text by XY-cut over word boxes instead of poppler's
+     * physical layout, which interleaves columns (default: enabled)
+     */
+    void setReadingOrder(bool enabled);
+    
+    /**
+     * Configure heading detection used by extractStructured
+     */
+    void setSectionOptions(const SectionOptions& options);
+    
+    /**
+     * Enable or disable table detection in extractStructured (default:
+     * enabled). Detected tables are returned as separate serialized
+     * tables and removed from the page text.
+     */
+    void setTableDetection(bool enabled);
+    
+    /**
+     * Configure table detection thresholds and output format
+     */
+    void setTableOptions(const TableOptions& options);
+    
+    /**
+     * Enable or disable in-place text normalization (default: enabled)
+     */
+    void setNormalize(bool enabled);
+    
+    /**
+     * Configure dehyphenation and line joining of the normalization pass
+     */
+    void setNormalizeOptions(const NormalizeOptions& options);
+    
+    /**
+     * Map input files instead of reading them into memory (default:
+     * disabled). Pages of the file are prefetched ahead of the page being
+     * extracted and released behind it, so the resident size of a large
+     * PDF stays bounded. Files over 2 GiB cannot be mapped.
+     */
+    void setMemoryMapping(bool enabled);
+    
+    /**
+     * Get normalization statistics for the last processed PDF
+     */
+    TextNormalizer::Stats getNormalizeStats() const;
+    
+    /**
+     * Get UTF-8 validation/repair statistics for the last processed PDF
+     */
+    Utf8Validator::Stats getUtf8Stats() const;
+    
 private:
     class Impl;
     std::unique_ptr<Impl> pImpl;  // Pimpl idiom for poppler types
@@ -0,0 +1,53 @@
+#include "PageLayout.h"
+#include <stdexcept>
+
+namespace guardian {
+
+void PageLayout::addWord(const char *data, size_t size, float x0, float y0,
+                         float x1, float y1, float fontSize, uint16_t fontId,
+                         uint8_t wordFlags) {
+  if (text.size() + size > UINT32_MAX) {
+    throw std::length_error("Page text exceeds 4 GiB");
+  }
+
+  text.append(data, size);
+  wordOffsets.push_back(static_cast<uint32_t>(text.size()));
+  boxes.insert(boxes.end(), {x0, y0, x1, y1});
+  fontSizes.push_back(fontSize);
+  fontIds.push_back(fontId);
+  flags.push_back(wordFlags);
+}
+
+void PageLayout::clear() {
+  text.clear();
+  wordOffsets.assign(1, 0);
+  boxes.clear();
+  fontSizes.clear();
+  fontIds.clear();
+  flags.clear();
+}
+
+void PageLayout::reserve(size_t words) {
+  wordOffsets.reserve(words + 1);
+  boxes.reserve(4 * words);
+  fontSizes.reserve(words);
+  fontIds.reserve(words);
+  flags.reserve(words);
+}
+
+std::string PageLayout::word(size_t i) const {
+  if (i >= wordCount()) {
+    throw std::out_of_range("Word index out of range");
+  }
+  return text.substr(wordOffsets[i], wordOffsets[i + 1] - wordOffsets[i]);
+}
+
+size_t PageLayout::memoryBytes() const {
+  return text.capacity() + wordOffsets.capacity() * sizeof(uint32_t) +
+         boxes.capacity() * sizeof(float) +
+         fontSizes.capacity() * sizeof(float) +
+         fontIds.capacity() * sizeof(uint16_t) +
+         flags.capacity() * sizeof(uint8_t);
+}
+
+} // namespace guardian
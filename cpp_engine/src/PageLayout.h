@@ -0,0 +1,78 @@
+#ifndef PAGE_LAYOUT_H
+#define PAGE_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * PageLayout - Words of one page with positions, as a struct of arrays
+ *
+ * Word i is text[wordOffsets[i], wordOffsets[i + 1]) in a single UTF-8
+ * arena. Boxes are stored as [x0, y0, x1, y1] in PDF points with the origin
+ * at the page's top-left corner, in poppler's content-stream order. Each
+ * word costs 27 bytes plus its text, and the columns map directly to numpy
+ * arrays without per-word objects.
+ */
+struct PageLayout {
+  static constexpr uint16_t NO_FONT = 0xFFFF;
+
+  // Bits of flags
+  static constexpr uint8_t SPACE_AFTER = 1 << 0;
+  static constexpr int ROTATION_SHIFT = 1; // Bits 1-2: rotation / 90 degrees
+  static constexpr uint8_t IN_TABLE = 1 << 3; // Set by TableDetector
+
+  int pageIndex = 0;
+  float width = 0;  // Page size in points
+  float height = 0;
+
+  std::string text;                       // UTF-8 arena
+  std::vector<uint32_t> wordOffsets{0};   // wordCount() + 1 entries
+  std::vector<float> boxes;               // 4 floats per word
+  std::vector<float> fontSizes;
+  std::vector<uint16_t> fontIds;          // Index into DocumentLayout::fonts
+  std::vector<uint8_t> flags;
+
+  size_t wordCount() const { return fontSizes.size(); }
+
+  /**
+   * Append a word and its attributes to every column
+   */
+  void addWord(const char *data, size_t size, float x0, float y0, float x1,
+               float y1, float fontSize, uint16_t fontId, uint8_t wordFlags);
+
+  /**
+   * Remove all words, keeping the columns' capacity
+   */
+  void clear();
+
+  /**
+   * Reserve every column for a number of words
+   */
+  void reserve(size_t words);
+
+  /**
+   * Copy of word i's text
+   */
+  std::string word(size_t i) const;
+
+  /**
+   * Bytes held by the columns (capacity, excluding the struct itself)
+   */
+  size_t memoryBytes() const;
+};
+
+/**
+ * DocumentLayout - Per-page layouts sharing one font table
+ */
+struct DocumentLayout {
+  std::vector<PageLayout> pages;
+  std::vector<std::string> fonts; // Font names indexed by font id
+};
+
+} // namespace guardian
+
+#endif // PAGE_LAYOUT_H
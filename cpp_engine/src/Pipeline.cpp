@@ -0,0 +1,280 @@
+#include "Pipeline.h"
+#include "PDFShredder.h"
+#include "RabinKarpDedup.h"
+#include "TextChunker.h"
+#include <stdexcept>
+#include <string_view>
+
+namespace guardian {
+
+/**
+ * Pipeline::Stage - One step over the pages or chunks of a run
+ */
+class Pipeline::Stage {
+public:
+  struct Context {
+    std::vector<std::string> &pages;
+    PipelineResult &result;
+    const std::string *filepath; // Set for run(), not runTexts()
+  };
+
+  virtual ~Stage() = default;
+  virtual const char *name() const = 0;
+  virtual void run(Context &context) = 0;
+};
+
+namespace {
+
+using Stage = Pipeline::Stage;
+
+class ExtractStage : public Stage {
+public:
+  explicit ExtractStage(const ResourceLimits &limits) : shredder_(limits) {
+    shredder_.setNormalize(false); // A stage of its own
+  }
+
+  const char *name() const override { return "extract"; }
+
+  void run(Context &context) override {
+    size_t count = 0;
+    shredder_.streamText(*context.filepath,
+                         [&](int, std::string &text) {
+                           if (count == context.pages.size())
+                             context.pages.emplace_back();
+                           context.pages[count++].assign(text);
+                         });
+    context.pages.resize(count);
+  }
+
+private:
+  PDFShredder shredder_;
+};
+
+class NormalizeStage : public Stage {
+public:
+  explicit NormalizeStage(const NormalizeOptions &options)
+      : normalizer_(options) {}
+
+  const char *name() const override { return "normalize"; }
+
+  void run(Context &context) override {
+    for (auto &page : context.pages)
+      normalizer_.normalize(page);
+  }
+
+private:
+  TextNormalizer normalizer_;
+};
+
+class BoilerplateStage : public Stage {
+public:
+  explicit BoilerplateStage(const BoilerplateOptions &options)
+      : filter_(options) {}
+
+  const char *name() const override { return "strip_boilerplate"; }
+
+  void run(Context &context) override { filter_.strip(context.pages); }
+
+private:
+  BoilerplateFilter filter_;
+};
+
+class ChunkStage : public Stage {
+public:
+  ChunkStage(int chunkSize, int overlapSize)
+      : chunker_(chunkSize, overlapSize) {}
+
+  const char *name() const override { return "chunk"; }
+
+  void run(Context &context) override {
+    context.result.chunks = chunker_.chunkMultiple(context.pages);
+  }
+
+private:
+  TextChunker chunker_;
+};
+
+class DedupStage : public Stage {
+public:
+  explicit DedupStage(double similarityThreshold)
+      : deduplicator_(similarityThreshold) {}
+
+  const char *name() const override { return "dedup"; }
+
+  void run(Context &context) override {
+    PipelineResult &result = context.result;
+    views_.assign(result.chunks.begin(), result.chunks.end());
+    std::vector<size_t> keep =
+        deduplicator_.findUnique(views_.data(), views_.size());
+    views_.clear();
+
+    // Compact the chunks and whatever earlier stages attached to them
+    auto compact = [&keep](auto &items) {
+      if (items.empty())
+        return;
+      for (size_t i = 0; i < keep.size(); ++i) {
+        if (keep[i] != i)
+          items[i] = std::move(items[keep[i]]);
+      }
+      items.resize(keep.size());
+    };
+    compact(result.chunks);
+    compact(result.findings);
+    compact(result.tokens);
+    for (size_t i = 0; i < result.findings.size(); ++i) {
+      for (auto &finding : result.findings[i])
+        finding.chunkIndex = static_cast<int>(i);
+    }
+  }
+
+private:
+  RabinKarpDeduplicator deduplicator_;
+  std::vector<std::string_view> views_;
+};
+
+class ScanStage : public Stage {
+public:
+  ScanStage(const ContentScanner &scanner, bool redact)
+      : scanner_(scanner), redact_(redact) {}
+
+  const char *name() const override { return "scan"; }
+
+  void run(Context &context) override {
+    PipelineResult &result = context.result;
+    result.findings.resize(result.chunks.size());
+    for (size_t i = 0; i < result.chunks.size(); ++i) {
+      std::vector<Finding> &findings = result.findings[i];
+      findings = scanner_.scan(result.chunks[i]);
+      for (auto &finding : findings)
+        finding.chunkIndex = static_cast<int>(i);
+      if (redact_ && !findings.empty())
+        result.chunks[i] = ContentScanner::redact(result.chunks[i], findings);
+    }
+  }
+
+private:
+  ContentScanner scanner_;
+  bool redact_;
+};
+
+class TokenizeStage : public Stage {
+public:
+  explicit TokenizeStage(std::shared_ptr<Vocabulary> vocabulary)
+      : vocabulary_(vocabulary ? std::move(vocabulary)
+                               : std::make_shared<Vocabulary>()) {}
+
+  const char *name() const override { return "tokenize"; }
+
+  void run(Context &context) override {
+    PipelineResult &result = context.result;
+    result.tokens.resize(result.chunks.size());
+    for (size_t i = 0; i < result.chunks.size(); ++i) {
+      result.tokens[i].clear();
+      const std::string &chunk = result.chunks[i];
+      vocabulary_->encode(chunk.data(), chunk.size(), result.tokens[i]);
+    }
+  }
+
+private:
+  std::shared_ptr<Vocabulary> vocabulary_;
+};
+
+} // namespace
+
+Pipeline::Pipeline() = default;
+
+Pipeline::~Pipeline() = default;
+
+Pipeline &Pipeline::add(std::unique_ptr<Stage> stage, Data input,
+                        Data output) {
+  if (output_ != input) {
+    static const char *const NAMES[] = {"nothing", "pages", "chunks"};
+    throw std::logic_error(std::string("Stage '") + stage->name() +
+                           "' needs " + NAMES[static_cast<int>(input)] +
+                           " but the pipeline produces " +
+                           NAMES[static_cast<int>(output_)] + " here");
+  }
+  std::lock_guard<std::mutex> lock(runMutex_);
+  stages_.push_back(std::move(stage));
+  output_ = output;
+  return *this;
+}
+
+Pipeline &Pipeline::extract(const ResourceLimits &limits) {
+  return add(std::make_unique<ExtractStage>(limits), Data::None, Data::Pages);
+}
+
+Pipeline &Pipeline::normalize(const NormalizeOptions &options) {
+  // Pages may also come from runTexts(), so normalize can start a pipeline
+  Data input = output_ == Data::None ? Data::None : Data::Pages;
+  return add(std::make_unique<NormalizeStage>(options), input, Data::Pages);
+}
+
+Pipeline &Pipeline::stripBoilerplate(const BoilerplateOptions &options) {
+  Data input = output_ == Data::None ? Data::None : Data::Pages;
+  return add(std::make_unique<BoilerplateStage>(options), input,
+             Data::Pages);
+}
+
+Pipeline &Pipeline::chunk(int chunkSize, int overlapSize) {
+  Data input = output_ == Data::None ? Data::None : Data::Pages;
+  return add(std::make_unique<ChunkStage>(chunkSize, overlapSize), input,
+             Data::Chunks);
+}
+
+Pipeline &Pipeline::dedup(double similarityThreshold) {
+  return add(std::make_unique<DedupStage>(similarityThreshold), Data::Chunks,
+             Data::Chunks);
+}
+
+Pipeline &Pipeline::scan(const ContentScanner &scanner, bool redact) {
+  return add(std::make_unique<ScanStage>(scanner, redact), Data::Chunks,
+             Data::Chunks);
+}
+
+Pipeline &Pipeline::tokenize(std::shared_ptr<Vocabulary> vocabulary) {
+  return add(std::make_unique<TokenizeStage>(std::move(vocabulary)),
+             Data::Chunks, Data::Chunks);
+}
+
+std::vector<std::string> Pipeline::stages() const {
+  std::vector<std::string> names;
+  for (const auto &stage : stages_)
+    names.emplace_back(stage->name());
+  return names;
+}
+
+PipelineResult Pipeline::run(const std::string &filepath) {
+  std::lock_guard<std::mutex> lock(runMutex_);
+  if (stages_.empty() || std::string_view(stages_[0]->name()) != "extract") {
+    throw std::logic_error("Pipeline does not start with extract");
+  }
+
+  return execute(&filepath);
+}
+
+PipelineResult Pipeline::runTexts(const std::vector<std::string> &pages) {
+  std::lock_guard<std::mutex> lock(runMutex_);
+  if (!stages_.empty() &&
+      std::string_view(stages_[0]->name()) == "extract") {
+    throw std::logic_error("Pipeline extracts its own pages");
+  }
+
+  pages_.resize(pages.size());
+  for (size_t i = 0; i < pages.size(); ++i)
+    pages_[i].assign(pages[i]);
+
+  return execute(nullptr);
+}
+
+PipelineResult Pipeline::execute(const std::string *filepath) {
+  PipelineResult result;
+  Stage::Context context{pages_, result, filepath};
+  for (auto &stage : stages_)
+    stage->run(context);
+  if (output_ != Data::Chunks)
+    result.chunks.assign(pages_.begin(), pages_.end());
+  return result;
+}
+
+} // namespace guardian
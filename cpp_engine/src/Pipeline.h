@@ -0,0 +1,119 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "BoilerplateFilter.h"
+#include "ContentScanner.h"
+#include "ResourceGuard.h"
+#include "TextNormalizer.h"
+#include "Vocabulary.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * PipelineResult - Output of one Pipeline run. The per-chunk lists are
+ * empty unless the pipeline has the stage producing them.
+ */
+struct PipelineResult {
+  std::vector<std::string> chunks;
+  std::vector<std::vector<Finding>> findings; // scan: offsets into chunks
+  std::vector<std::vector<uint32_t>> tokens;  // tokenize: vocabulary ids
+};
+
+/**
+ * Pipeline - Document processing stages composed once, run many times
+ *
+ * Stages are appended in execution order and checked as they are added:
+ *
+ *   extract            -> pages     (optional: runTexts() supplies pages)
+ *   normalize, stripBoilerplate     pages -> pages
+ *   chunk              pages -> chunks
+ *   dedup, scan, tokenize           chunks -> chunks
+ *
+ * A pipeline that ends with pages returns them as its chunks. Stage
+ * objects (extractor, normalizer tables, scanner automata, vocabulary)
+ * and page buffers are built once and reused by every run, which is
+ * entirely native code. Runs of one Pipeline are serialized; use one per
+ * thread for parallel documents.
+ */
+class Pipeline {
+public:
+  Pipeline();
+  ~Pipeline();
+
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+
+  /**
+   * Extract page text in reading order (first stage)
+   */
+  Pipeline &extract(const ResourceLimits &limits = ResourceLimits());
+
+  Pipeline &normalize(const NormalizeOptions &options = NormalizeOptions());
+
+  /**
+   * Remove running headers, footers and page numbers; best placed before
+   * normalize, which may join them to neighbouring lines
+   */
+  Pipeline &
+  stripBoilerplate(const BoilerplateOptions &options = BoilerplateOptions());
+
+  Pipeline &chunk(int chunkSize = 500, int overlapSize = 50);
+
+  Pipeline &dedup(double similarityThreshold = 0.9);
+
+  /**
+   * Scan chunks for PII/secrets, optionally masking what was found (later
+   * stages see the masked text)
+   */
+  Pipeline &scan(const ContentScanner &scanner, bool redact = false);
+
+  /**
+   * Map each chunk to case-folded word ids
+   * @param vocabulary Shared vocabulary; nullptr = one owned by the
+   *        pipeline, kept across runs
+   */
+  Pipeline &tokenize(std::shared_ptr<Vocabulary> vocabulary = nullptr);
+
+  /**
+   * Run on a PDF file; the pipeline must start with extract
+   * @throws std::logic_error if it does not
+   * @throws std::runtime_error if file cannot be opened or parsed
+   * @throws ResourceLimitError if the document exceeds a resource limit
+   */
+  PipelineResult run(const std::string &filepath);
+
+  /**
+   * Run on page texts; the pipeline must not start with extract
+   * @throws std::logic_error if it does
+   */
+  PipelineResult runTexts(const std::vector<std::string> &pages);
+
+  /**
+   * Stage names in execution order
+   */
+  std::vector<std::string> stages() const;
+
+  class Stage;
+
+private:
+  enum class Data { None, Pages, Chunks };
+
+  std::vector<std::unique_ptr<Stage>> stages_;
+  Data output_ = Data::None;
+  std::mutex runMutex_;
+
+  // Reused across runs
+  std::vector<std::string> pages_;
+
+  Pipeline &add(std::unique_ptr<Stage> stage, Data input, Data output);
+  PipelineResult execute(const std::string *filepath);
+};
+
+} // namespace guardian
+
+#endif // PIPELINE_H
@@ -0,0 +1,168 @@
+#include "ProcessingPipeline.h"
+#include "BoundedQueue.h"
+#include "RabinKarpDedup.h"
+#include "TextChunker.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace guardian {
+
+namespace {
+
+struct PageText {
+  int index = 0;
+  std::string text;
+};
+
+struct PageChunks {
+  int index = 0;
+  std::vector<std::string> chunks;
+};
+
+// Thrown through PDFShredder::streamText when another stage failed
+struct Cancelled {};
+
+} // namespace
+
+ProcessingPipeline::ProcessingPipeline(const PipelineOptions &options,
+                                       const ResourceLimits &limits)
+    : options_(options), shredder_(limits) {
+  TextChunker::validate(options.chunkSize, options.overlapSize);
+}
+
+std::vector<std::string>
+ProcessingPipeline::process(const std::string &filepath) {
+  stats_ = {};
+  const size_t window = std::max<size_t>(options_.queueCapacity, 1);
+  BoundedQueue<PageChunks> chunked(window);
+
+  // Pages handed to the pool and not yet deduplicated, and pages being
+  // chunked; extraction waits while either is at its limit
+  std::mutex windowMutex;
+  std::condition_variable windowFreed;
+  size_t inFlight = 0, chunking = 0;
+  bool stopped = false;
+
+  // The first error closes the queue and stops extraction, which winds
+  // down every stage
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto fail = [&]() {
+    {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error)
+        error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(windowMutex);
+      stopped = true;
+    }
+    windowFreed.notify_all();
+    chunked.close();
+  };
+
+  std::thread extractor([&]() {
+    TaskGroup group;
+    try {
+      shredder_.streamText(filepath, [&](int index, std::string &text) {
+        {
+          std::unique_lock<std::mutex> lock(windowMutex);
+          windowFreed.wait(lock, [&]() {
+            return stopped || (inFlight < window &&
+                               (options_.chunkThreads == 0 ||
+                                chunking < options_.chunkThreads));
+          });
+          if (stopped)
+            throw Cancelled();
+          ++inFlight;
+          ++chunking;
+        }
+        group.run([&, page = PageText{index, std::move(text)}]() {
+          try {
+            TextChunker chunker(options_.chunkSize, options_.overlapSize);
+            PageChunks result{page.index, chunker.chunk(page.text)};
+            // Never full: no more than `window` pages are in flight
+            chunked.tryPush(result);
+          } catch (...) {
+            fail();
+          }
+          {
+            std::lock_guard<std::mutex> lock(windowMutex);
+            --chunking;
+          }
+          windowFreed.notify_all();
+        });
+      });
+    } catch (const Cancelled &) {
+    } catch (...) {
+      fail();
+    }
+    group.wait(); // Chunk tasks report their own errors
+    chunked.close();
+  });
+
+  // Deduplication on this thread, in page order. Unique chunks are
+  // referenced by the deduplicator until the end, so pages stay in place
+  // and the result is assembled afterwards.
+  std::vector<std::vector<std::string>> byPage;
+  std::vector<char> arrived;
+  std::vector<std::pair<size_t, size_t>> keep; // (page, chunk)
+  try {
+    RabinKarpDeduplicator deduplicator(options_.similarityThreshold);
+    if (options_.dedup)
+      deduplicator.reset();
+
+    size_t next = 0, held = 0;
+    PageChunks page;
+    while (chunked.pop(page)) {
+      size_t index = static_cast<size_t>(page.index);
+      if (index >= byPage.size()) {
+        byPage.resize(index + 1);
+        arrived.resize(index + 1, 0);
+      }
+      byPage[index] = std::move(page.chunks);
+      arrived[index] = 1;
+      ++held;
+
+      size_t released = 0;
+      for (; next < arrived.size() && arrived[next]; ++next, --held) {
+        ++released;
+        const std::vector<std::string> &chunks = byPage[next];
+        stats_.chunks += chunks.size();
+        for (size_t c = 0; c < chunks.size(); ++c) {
+          if (!options_.dedup || deduplicator.add(chunks[c]))
+            keep.emplace_back(next, c);
+        }
+      }
+      stats_.maxReordered = std::max(stats_.maxReordered, held);
+      if (released > 0) {
+        {
+          std::lock_guard<std::mutex> lock(windowMutex);
+          inFlight -= released;
+        }
+        windowFreed.notify_all();
+      }
+    }
+  } catch (...) {
+    fail();
+  }
+
+  extractor.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  std::vector<std::string> result;
+  result.reserve(keep.size());
+  for (const auto &[p, c] : keep)
+    result.push_back(std::move(byPage[p][c]));
+  stats_.pages = byPage.size();
+  stats_.uniqueChunks = result.size();
+  return result;
+}
+
+} // namespace guardian
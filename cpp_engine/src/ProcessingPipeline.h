@@ -0,0 +1,84 @@
+#ifndef PROCESSING_PIPELINE_H
+#define PROCESSING_PIPELINE_H
+
+#include "PDFShredder.h"
+#include "ResourceGuard.h"
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * PipelineOptions - Stage parameters of ProcessingPipeline
+ */
+struct PipelineOptions {
+  int chunkSize = 500;              // Words per chunk
+  int overlapSize = 50;             // Overlapping words between chunks
+  bool dedup = true;                // Drop near-duplicate chunks
+  double similarityThreshold = 0.9; // Jaccard similarity of duplicates
+  unsigned chunkThreads = 0;        // Pages chunked at once, 0 = no cap
+  size_t queueCapacity = 16;        // Pages in flight past extraction
+};
+
+/**
+ * ProcessingPipeline - Extract, chunk and deduplicate with overlapped
+ * stages
+ *
+ *   extraction thread --pages--> chunk tasks --chunks--> deduplication
+ *
+ * Stages run concurrently, so end-to-end time approaches that of the
+ * slowest stage. Extraction waits while queueCapacity pages are between it
+ * and deduplication, counting pages held back to restore page order, so
+ * page text in flight stays bounded however fast extraction is. The chunks
+ * themselves are kept until process() returns them. Extraction is a single
+ * thread (a poppler document must not be shared between threads); each page
+ * is chunked by a task on the shared ThreadPool, so concurrent calls share
+ * its workers instead of starting threads of their own. process() must not
+ * be called from a task of the shared pool. Deduplication runs on the
+ * calling thread and restores page order before it sees a page, so the
+ * result is identical to extracting, chunking page by page and
+ * deduplicating in sequence.
+ * An error in any stage cancels the others and is rethrown by process().
+ */
+class ProcessingPipeline {
+public:
+  explicit ProcessingPipeline(const PipelineOptions &options = {},
+                              const ResourceLimits &limits = {});
+
+  /**
+   * Run the pipeline on one document
+   * @param filepath Absolute path to PDF file
+   * @return Unique chunks in document order
+   * @throws std::runtime_error if file cannot be opened or parsed
+   * @throws ResourceLimitError if the document exceeds a resource limit
+   */
+  std::vector<std::string> process(const std::string &filepath);
+
+  struct Stats {
+    size_t pages;         // Pages extracted
+    size_t chunks;        // Chunks before deduplication
+    size_t uniqueChunks;  // Chunks returned
+    size_t maxReordered;  // Most pages held back (< queueCapacity)
+  };
+
+  /**
+   * Statistics of the last process() call
+   */
+  Stats getStats() const { return stats_; }
+
+  const PipelineOptions &getOptions() const { return options_; }
+
+  /**
+   * The extractor, for reading order, normalization and limit settings
+   */
+  PDFShredder &shredder() { return shredder_; }
+
+private:
+  PipelineOptions options_;
+  PDFShredder shredder_;
+  Stats stats_{};
+};
+
+} // namespace guardian
+
+#endif // PROCESSING_PIPELINE_H
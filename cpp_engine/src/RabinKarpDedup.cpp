@@ -1,6 +1,7 @@
 #include "RabinKarpDedup.h"
+#include "Arena.h"
 #include <algorithm>
-#include <sstream>
+#include <optional>
 #include <unordered_map>
 
 namespace guardian {
@@ -11,7 +12,7 @@ RabinKarpDeduplicator::RabinKarpDeduplicator(double similarityThreshold)
 }
 
 unsigned long long
-RabinKarpDeduplicator::computeHash(const std::string &text) const {
+RabinKarpDeduplicator::computeHash(std::string_view text) const {
   unsigned long long hash = 0;
   unsigned long long pow = 1;
 
@@ -23,39 +24,31 @@ RabinKarpDeduplicator::computeHash(const std::string &text) const {
   return hash;
 }
 
-std::unordered_set<std::string>
-RabinKarpDeduplicator::getNGrams(const std::string &text, int n) const {
-  std::unordered_set<std::string> ngrams;
-  std::istringstream stream(text);
-  std::vector<std::string> words;
-  std::string word;
-
-  // Split into words
-  while (stream >> word) {
-    // Convert to lowercase for comparison
-    std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-    words.push_back(word);
-  }
+void RabinKarpDeduplicator::getNGrams(std::string_view text,
+                                      Vocabulary &vocabulary,
+                                      NGramSet &ngrams, int n) const {
+  // Words are case-folded and interned once (CJK runs as characters), so
+  // an n-gram is a hash of n ids rather than a string
+  thread_local std::vector<uint32_t> ids;
+  ids.clear();
+  vocabulary.encode(text.data(), text.size(), ids);
 
   // Generate n-grams
-  for (size_t i = 0; i + n <= words.size(); ++i) {
-    std::string ngram;
-    for (int j = 0; j < n; ++j) {
-      if (j > 0)
-        ngram += " ";
-      ngram += words[i + j];
-    }
-    ngrams.insert(ngram);
+  if (ids.size() >= static_cast<size_t>(n)) {
+    ngrams.reserve(ids.size() - n + 1);
   }
-
-  return ngrams;
+  for (size_t w = 0; w + n <= ids.size(); ++w) {
+    uint64_t hash = 0;
+    for (int j = 0; j < n; ++j)
+      hash = (hash + ids[w + j] + 1) * 0x9E3779B97F4A7C15ull;
+    ngrams.push_back(hash ^ (hash >> 31));
+  }
+  std::sort(ngrams.begin(), ngrams.end());
+  ngrams.erase(std::unique(ngrams.begin(), ngrams.end()), ngrams.end());
 }
 
-double RabinKarpDeduplicator::calculateSimilarity(const std::string &a,
-                                                  const std::string &b) const {
-  auto ngramsA = getNGrams(a);
-  auto ngramsB = getNGrams(b);
-
+double RabinKarpDeduplicator::calculateSimilarity(const NGramSet &ngramsA,
+                                                  const NGramSet &ngramsB) {
   if (ngramsA.empty() && ngramsB.empty()) {
     return 1.0; // Both empty = identical
   }
@@ -64,11 +57,18 @@ double RabinKarpDeduplicator::calculateSimilarity(const std::string &a,
     return 0.0; // One empty = completely different
   }
 
-  // Jaccard similarity: |A ∩ B| / |A ∪ B|
+  // Jaccard similarity: |A ∩ B| / |A ∪ B|, merging the sorted sets
   int intersection = 0;
-  for (const auto &ngram : ngramsA) {
-    if (ngramsB.count(ngram)) {
+  auto a = ngramsA.begin(), b = ngramsB.begin();
+  while (a != ngramsA.end() && b != ngramsB.end()) {
+    if (*a < *b) {
+      ++a;
+    } else if (*b < *a) {
+      ++b;
+    } else {
       intersection++;
+      ++a;
+      ++b;
     }
   }
 
@@ -78,57 +78,111 @@ double RabinKarpDeduplicator::calculateSimilarity(const std::string &a,
 
 std::vector<std::string>
 RabinKarpDeduplicator::deduplicate(const std::vector<std::string> &chunks) {
+  std::vector<std::string_view> views(chunks.begin(), chunks.end());
   std::vector<std::string> uniqueChunks;
-  std::unordered_map<unsigned long long, std::vector<int>> hashToIndices;
 
-  stats_.originalCount = chunks.size();
-  stats_.uniqueCount = 0;
-  stats_.duplicatesRemoved = 0;
+  for (size_t i : findUnique(views.data(), views.size()))
+    uniqueChunks.push_back(chunks[i]);
 
-  // Group chunks by hash
-  for (size_t i = 0; i < chunks.size(); ++i) {
-    unsigned long long hash = computeHash(chunks[i]);
-    hashToIndices[hash].push_back(i);
-  }
-
-  std::vector<bool> isDuplicate(chunks.size(), false);
+  return uniqueChunks;
+}
 
-  // For each hash bucket, check actual similarity
-  for (const auto &[hash, indices] : hashToIndices) {
-    for (size_t i = 0; i < indices.size(); ++i) {
-      if (isDuplicate[indices[i]])
-        continue;
+// Working data of a deduplication stream. The lease is declared first so
+// that it outlives the containers allocated from it.
+struct RabinKarpDeduplicator::StreamState {
+  std::optional<ArenaPool::Lease> lease;
+  std::pmr::memory_resource *memory;
+  std::optional<Vocabulary> localVocabulary;
+  Vocabulary *vocabulary;
+
+  // Unique chunks so far, grouped by hash; n-grams are built at most once
+  // per chunk, and only for chunks that share a bucket
+  std::pmr::unordered_map<unsigned long long, std::pmr::vector<uint32_t>>
+      buckets;
+  std::pmr::vector<std::string_view> unique;
+  std::pmr::vector<NGramSet> ngrams;
+  std::pmr::vector<char> built;
+  NGramSet candidate;
+
+  StreamState(std::pmr::memory_resource *resource, Vocabulary *shared)
+      : lease(resource ? std::nullopt
+                       : std::optional<ArenaPool::Lease>(ArenaPool::acquire())),
+        memory(resource ? resource : lease->resource()), vocabulary(shared),
+        buckets(memory), unique(memory), ngrams(memory), built(memory),
+        candidate(memory) {}
+
+  Vocabulary &words() {
+    if (!vocabulary)
+      vocabulary = &localVocabulary.emplace();
+    return *vocabulary;
+  }
+};
 
-      for (size_t j = i + 1; j < indices.size(); ++j) {
-        if (isDuplicate[indices[j]])
-          continue;
+RabinKarpDeduplicator::~RabinKarpDeduplicator() = default;
 
-        double similarity =
-            calculateSimilarity(chunks[indices[i]], chunks[indices[j]]);
+void RabinKarpDeduplicator::reset(std::pmr::memory_resource *memory) {
+  stream_.reset(); // Before its arena can be handed out again
+  stream_ = std::make_unique<StreamState>(memory, vocabulary_.get());
+  stats_ = {0, 0, 0, 0.0};
+}
 
-        if (similarity >= similarityThreshold_) {
-          isDuplicate[indices[j]] = true;
-          stats_.duplicatesRemoved++;
-        }
+bool RabinKarpDeduplicator::add(std::string_view chunk) {
+  if (!stream_) {
+    reset();
+  }
+  StreamState &s = *stream_;
+  stats_.originalCount++;
+
+  auto &bucket = s.buckets[computeHash(chunk)];
+  bool duplicate = false;
+  if (!bucket.empty()) {
+    s.candidate.clear();
+    getNGrams(chunk, s.words(), s.candidate);
+    for (uint32_t k : bucket) {
+      if (!s.built[k]) {
+        getNGrams(s.unique[k], s.words(), s.ngrams[k]);
+        s.built[k] = 1;
+      }
+      if (calculateSimilarity(s.ngrams[k], s.candidate) >=
+          similarityThreshold_) {
+        duplicate = true;
+        break;
       }
     }
   }
 
-  // Collect unique chunks
-  for (size_t i = 0; i < chunks.size(); ++i) {
-    if (!isDuplicate[i]) {
-      uniqueChunks.push_back(chunks[i]);
+  if (duplicate) {
+    stats_.duplicatesRemoved++;
+  } else {
+    bucket.push_back(static_cast<uint32_t>(s.unique.size()));
+    s.unique.push_back(chunk);
+    s.ngrams.emplace_back();
+    s.built.push_back(0);
+    if (bucket.size() > 1) {
+      s.ngrams.back() = s.candidate;
+      s.built.back() = 1;
     }
+    stats_.uniqueCount++;
   }
 
-  stats_.uniqueCount = uniqueChunks.size();
   stats_.deduplicationRatio =
-      stats_.originalCount > 0
-          ? 1.0 -
-                (static_cast<double>(stats_.uniqueCount) / stats_.originalCount)
-          : 0.0;
+      1.0 - (static_cast<double>(stats_.uniqueCount) / stats_.originalCount);
+  return !duplicate;
+}
 
-  return uniqueChunks;
+std::vector<size_t>
+RabinKarpDeduplicator::findUnique(const std::string_view *chunks, size_t count,
+                                  std::pmr::memory_resource *memory) {
+  reset(memory);
+
+  std::vector<size_t> unique;
+  for (size_t i = 0; i < count; ++i) {
+    if (add(chunks[i]))
+      unique.push_back(i);
+  }
+
+  stream_.reset(); // Working data is freed with the call
+  return unique;
 }
 
 } // namespace guardian
@@ -1,8 +1,11 @@
 #ifndef RABIN_KARP_DEDUP_H
 #define RABIN_KARP_DEDUP_H
 
+#include "Vocabulary.h"
+#include <memory>
+#include <memory_resource>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
 namespace guardian {
@@ -30,6 +33,35 @@ public:
    */
   std::vector<std::string> deduplicate(const std::vector<std::string> &chunks);
 
+  /**
+   * Find the chunks deduplicate() would keep
+   * @param chunks Input chunks
+   * @param count Number of chunks
+   * @param memory Allocates all working data (hash buckets, n-gram sets);
+   *        nullptr = an arena leased from ArenaPool for the call
+   * @return Indices of unique chunks, ascending
+   */
+  std::vector<size_t> findUnique(const std::string_view *chunks, size_t count,
+                                 std::pmr::memory_resource *memory = nullptr);
+
+  /**
+   * Start incremental deduplication: chunks passed to add() are checked
+   * against the unique chunks added before them, with the same result as
+   * deduplicating them all at once. Statistics restart.
+   * @param memory Allocates the working data until the next reset() or
+   *        destruction; nullptr = an arena leased from ArenaPool
+   */
+  void reset(std::pmr::memory_resource *memory = nullptr);
+
+  /**
+   * Add the next chunk (starting a stream if none is open)
+   * @param chunk Must stay valid until reset() if it is unique
+   * @return true if the chunk is unique so far
+   */
+  bool add(std::string_view chunk);
+
+  ~RabinKarpDeduplicator();
+
   /**
    * Get statistics from last deduplication run
    */
@@ -42,29 +74,44 @@ public:
 
   Stats getStats() const { return stats_; }
 
+  /**
+   * Intern words into a vocabulary shared with other stages. By default
+   * each call uses a vocabulary of its own, created on first need.
+   */
+  void setVocabulary(std::shared_ptr<Vocabulary> vocabulary) {
+    vocabulary_ = std::move(vocabulary);
+  }
+
 private:
   double similarityThreshold_;
   Stats stats_;
+  std::shared_ptr<Vocabulary> vocabulary_;
+
+  struct StreamState;
+  std::unique_ptr<StreamState> stream_;
 
   // Rabin-Karp parameters
   static constexpr unsigned long long BASE = 257;
   static constexpr unsigned long long MOD = 1000000007;
 
+  // Hashes of word-id n-grams, sorted and unique
+  using NGramSet = std::pmr::vector<uint64_t>;
+
   /**
    * Compute rolling hash for a string
    */
-  unsigned long long computeHash(const std::string &text) const;
+  unsigned long long computeHash(std::string_view text) const;
 
   /**
-   * Calculate Jaccard similarity between two strings
+   * Calculate Jaccard similarity between two n-gram sets
    */
-  double calculateSimilarity(const std::string &a, const std::string &b) const;
+  static double calculateSimilarity(const NGramSet &a, const NGramSet &b);
 
   /**
-   * Convert string to set of word n-grams for similarity comparison
+   * Convert text to a set of word n-grams for similarity comparison
    */
-  std::unordered_set<std::string> getNGrams(const std::string &text,
-                                            int n = 3) const;
+  void getNGrams(std::string_view text, Vocabulary &vocabulary,
+                 NGramSet &ngrams, int n = 3) const;
 };
 
 } // namespace guardian
@@ -0,0 +1,728 @@
+#include "ResourceGuard.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+
+namespace guardian {
+
+namespace {
+
+constexpr size_t INFLATE_WINDOW = 64 * 1024;
+
+bool isWhitespace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' ||
+         c == '\0';
+}
+
+bool isDelimiter(char c) {
+  return isWhitespace(c) || c == '/' || c == '<' || c == '>' || c == '[' ||
+         c == ']' || c == '(' || c == ')' || c == '%';
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+size_t skipWhitespace(std::string_view s, size_t pos) {
+  while (pos < s.size() && isWhitespace(s[pos]))
+    ++pos;
+  return pos;
+}
+
+// Parse an unsigned integer at pos; returns false if there is none.
+bool parseUnsigned(std::string_view s, size_t &pos, size_t &value) {
+  size_t start = pos;
+  value = 0;
+  while (pos < s.size() && isDigit(s[pos])) {
+    value = value * 10 + static_cast<size_t>(s[pos] - '0');
+    ++pos;
+  }
+  return pos > start;
+}
+
+// Find a name key (e.g. "/Length") as a whole token, returning the position
+// just past it or npos.
+size_t findKey(std::string_view dict, std::string_view key) {
+  size_t pos = 0;
+  while ((pos = dict.find(key, pos)) != std::string_view::npos) {
+    size_t end = pos + key.size();
+    if (end >= dict.size() || isDelimiter(dict[end]))
+      return end;
+    pos = end;
+  }
+  return std::string_view::npos;
+}
+
+// Return the name value following a key, e.g. "/Pages" for "/Type /Pages".
+// For arrays the first name is returned.
+std::string_view nameValue(std::string_view dict, std::string_view key) {
+  size_t pos = findKey(dict, key);
+  if (pos == std::string_view::npos)
+    return {};
+  pos = skipWhitespace(dict, pos);
+  if (pos < dict.size() && dict[pos] == '[')
+    pos = skipWhitespace(dict, pos + 1);
+  if (pos >= dict.size() || dict[pos] != '/')
+    return {};
+  size_t end = pos + 1;
+  while (end < dict.size() && !isDelimiter(dict[end]))
+    ++end;
+  return dict.substr(pos, end - pos);
+}
+
+// Collect the filter names of a stream in decoding order ("/Filter /A" or
+// "/Filter [/A /B]"). Returns false if the chain cannot be read directly,
+// e.g. for an indirect "/Filter 12 0 R".
+bool filterChain(std::string_view dict,
+                 std::vector<std::string_view> &filters) {
+  size_t pos = findKey(dict, "/Filter");
+  if (pos == std::string_view::npos)
+    return true;
+  pos = skipWhitespace(dict, pos);
+  bool array = pos < dict.size() && dict[pos] == '[';
+  if (array)
+    ++pos;
+
+  while (true) {
+    pos = skipWhitespace(dict, pos);
+    if (pos >= dict.size())
+      return false;
+    if (array && dict[pos] == ']')
+      return true;
+    if (dict[pos] != '/')
+      return false;
+    size_t end = pos + 1;
+    while (end < dict.size() && !isDelimiter(dict[end]))
+      ++end;
+    filters.push_back(dict.substr(pos, end - pos));
+    if (!array)
+      return true;
+    pos = end;
+  }
+}
+
+enum class Filter { Flate, Lzw, AsciiHex, Ascii85, RunLength, Other };
+
+Filter filterKind(std::string_view name) {
+  if (name == "/FlateDecode" || name == "/Fl")
+    return Filter::Flate;
+  if (name == "/LZWDecode" || name == "/LZW")
+    return Filter::Lzw;
+  if (name == "/ASCIIHexDecode" || name == "/AHx")
+    return Filter::AsciiHex;
+  if (name == "/ASCII85Decode" || name == "/A85")
+    return Filter::Ascii85;
+  if (name == "/RunLengthDecode" || name == "/RL")
+    return Filter::RunLength;
+  return Filter::Other; // Image codecs, Crypt
+}
+
+int hexDigit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+// Two digits per byte: ASCIIHex halves its input and needs no budget
+void decodeAsciiHex(std::string_view in, std::string &out) {
+  int high = -1;
+  for (char c : in) {
+    if (c == '>')
+      break;
+    int digit = hexDigit(c);
+    if (digit < 0)
+      continue; // Whitespace; poppler reports real garbage
+    if (high < 0) {
+      high = digit;
+    } else {
+      out += static_cast<char>(high << 4 | digit);
+      high = -1;
+    }
+  }
+  if (high >= 0)
+    out += static_cast<char>(high << 4);
+}
+
+// Return a direct integer value following a key. Indirect references
+// ("12 0 R") are reported as missing.
+bool intValue(std::string_view dict, std::string_view key, size_t &value) {
+  size_t pos = findKey(dict, key);
+  if (pos == std::string_view::npos)
+    return false;
+  pos = skipWhitespace(dict, pos);
+  if (!parseUnsigned(dict, pos, value))
+    return false;
+
+  size_t look = skipWhitespace(dict, pos);
+  size_t gen;
+  if (parseUnsigned(dict, look, gen)) {
+    look = skipWhitespace(dict, look);
+    if (look < dict.size() && dict[look] == 'R')
+      return false;
+  }
+  return true;
+}
+
+// Collect object numbers from "/Kids [1 0 R 2 0 R ...]".
+std::vector<size_t> kidRefs(std::string_view dict) {
+  std::vector<size_t> kids;
+  size_t pos = findKey(dict, "/Kids");
+  if (pos == std::string_view::npos)
+    return kids;
+  pos = skipWhitespace(dict, pos);
+  if (pos >= dict.size() || dict[pos] != '[')
+    return kids;
+  ++pos;
+
+  while (true) {
+    pos = skipWhitespace(dict, pos);
+    size_t num, gen;
+    if (!parseUnsigned(dict, pos, num))
+      break;
+    pos = skipWhitespace(dict, pos);
+    if (!parseUnsigned(dict, pos, gen))
+      break;
+    pos = skipWhitespace(dict, pos);
+    if (pos >= dict.size() || dict[pos] != 'R')
+      break;
+    ++pos;
+    kids.push_back(num);
+  }
+  return kids;
+}
+
+// Given the offset of an "obj" keyword, verify it is preceded by "N G".
+bool objectHeader(std::string_view s, size_t objPos, size_t &objNum) {
+  if (objPos == 0 || !isWhitespace(s[objPos - 1]))
+    return false;
+  size_t pos = objPos;
+  while (pos > 0 && isWhitespace(s[pos - 1]))
+    --pos;
+  size_t genEnd = pos;
+  while (pos > 0 && isDigit(s[pos - 1]))
+    --pos;
+  if (pos == genEnd || pos == 0 || !isWhitespace(s[pos - 1]))
+    return false;
+  while (pos > 0 && isWhitespace(s[pos - 1]))
+    --pos;
+  size_t numEnd = pos;
+  while (pos > 0 && isDigit(s[pos - 1]))
+    --pos;
+  if (pos == numEnd)
+    return false;
+  size_t cursor = pos;
+  return parseUnsigned(s, cursor, objNum);
+}
+
+class Scanner {
+public:
+  Scanner(const ResourceLimits &limits, ResourceGuard::Stats &stats)
+      : limits_(limits), stats_(stats) {}
+
+  void run(std::string_view pdf) {
+    checkEncryption(pdf);
+    size_t pos = 0;
+    while ((pos = pdf.find("obj", pos)) != std::string_view::npos) {
+      size_t objNum;
+      size_t bodyStart = pos + 3;
+      if (bodyStart < pdf.size() && !isDelimiter(pdf[bodyStart])) {
+        pos = bodyStart;
+        continue;
+      }
+      if (!objectHeader(pdf, pos, objNum)) {
+        pos = bodyStart;
+        continue;
+      }
+      countObjects(1);
+      pos = scanObject(pdf, objNum, bodyStart);
+    }
+    checkPageTree();
+  }
+
+private:
+  const ResourceLimits &limits_;
+  ResourceGuard::Stats &stats_;
+  std::unordered_map<size_t, std::vector<size_t>> pageNodes_;
+
+  // Streams of an encrypted document are ciphertext: their real size
+  // cannot be known before poppler decrypts them
+  void checkEncryption(std::string_view pdf) {
+    if (!limits_.maxStreamBytes && !limits_.maxDocumentBytes)
+      return;
+    for (size_t pos = 0;
+         (pos = pdf.find("trailer", pos)) != std::string_view::npos; pos += 7) {
+      size_t end = pdf.find("startxref", pos);
+      if (end == std::string_view::npos)
+        end = pdf.size();
+      rejectEncrypted(pdf.substr(pos, end - pos));
+    }
+  }
+
+  void rejectEncrypted(std::string_view dict) {
+    if (findKey(dict, "/Encrypt") != std::string_view::npos) {
+      throw ResourceLimitError(ResourceLimitError::Kind::Encrypted, 0, 0,
+                               "Encrypted PDF streams cannot be budgeted");
+    }
+  }
+
+  void countObjects(size_t n) {
+    stats_.objectCount += n;
+    if (limits_.maxObjects && stats_.objectCount > limits_.maxObjects) {
+      throw ResourceLimitError(ResourceLimitError::Kind::ObjectCount,
+                               limits_.maxObjects, stats_.objectCount,
+                               "PDF object count exceeds limit");
+    }
+  }
+
+  void notePageNode(size_t objNum, std::string_view dict) {
+    if (nameValue(dict, "/Type") == "/Pages")
+      pageNodes_[objNum] = kidRefs(dict);
+  }
+
+  // Scan one object body; returns the position to resume searching from.
+  size_t scanObject(std::string_view pdf, size_t objNum, size_t bodyStart) {
+    size_t endObj = pdf.find("endobj", bodyStart);
+    size_t streamKw = pdf.find("stream", bodyStart);
+
+    // "endstream" also contains "stream"; only a bare keyword opens data
+    bool hasStream = streamKw != std::string_view::npos &&
+                     (endObj == std::string_view::npos || streamKw < endObj) &&
+                     (streamKw < 3 || pdf.substr(streamKw - 3, 3) != "end");
+
+    if (!hasStream) {
+      size_t end = endObj == std::string_view::npos ? pdf.size() : endObj;
+      notePageNode(objNum, pdf.substr(bodyStart, end - bodyStart));
+      return end == pdf.size() ? end : end + 6;
+    }
+
+    std::string_view dict = pdf.substr(bodyStart, streamKw - bodyStart);
+    notePageNode(objNum, dict);
+    if (nameValue(dict, "/Type") == "/XRef" &&
+        (limits_.maxStreamBytes || limits_.maxDocumentBytes))
+      rejectEncrypted(dict); // A cross-reference stream is the trailer
+
+    size_t dataStart = streamKw + 6;
+    if (dataStart < pdf.size() && pdf[dataStart] == '\r')
+      ++dataStart;
+    if (dataStart < pdf.size() && pdf[dataStart] == '\n')
+      ++dataStart;
+
+    // Trust /Length only if "endstream" follows it; otherwise search for it
+    size_t dataEnd = std::string_view::npos;
+    size_t length;
+    if (intValue(dict, "/Length", length) && length <= pdf.size() - dataStart) {
+      size_t after = skipWhitespace(pdf, dataStart + length);
+      if (pdf.substr(after, 9) == "endstream")
+        dataEnd = dataStart + length;
+    }
+    if (dataEnd == std::string_view::npos) {
+      dataEnd = pdf.find("endstream", dataStart);
+      if (dataEnd == std::string_view::npos)
+        dataEnd = pdf.size();
+    }
+
+    ++stats_.streamCount;
+    std::string_view data = pdf.substr(dataStart, dataEnd - dataStart);
+    bool isObjStm = nameValue(dict, "/Type") == "/ObjStm";
+
+    std::string decoded;
+    if (decodeStream(dict, data, decoded, isObjStm) && isObjStm)
+      scanObjectStream(dict, data);
+
+    return dataEnd;
+  }
+
+  // Run a stream's filter chain up to its last Flate or LZW stage,
+  // budgeting every stage that expands, or to the end when the content is
+  // needed.
+  // On return data holds the last output; returns false if the content
+  // was not decoded completely.
+  bool decodeStream(std::string_view dict, std::string_view &data,
+                    std::string &buffer, bool needContent) {
+    std::vector<std::string_view> filters;
+    if (!filterChain(dict, filters)) {
+      throw ResourceLimitError(ResourceLimitError::Kind::StreamFilter, 0, 0,
+                               "PDF stream filter is an indirect reference");
+    }
+
+    size_t stages = 0;
+    bool decodable = true;
+    for (size_t i = 0; i < filters.size(); ++i) {
+      Filter kind = filterKind(filters[i]);
+      if (kind == Filter::Flate || kind == Filter::Lzw) {
+        if (!decodable) {
+          throw ResourceLimitError(
+              ResourceLimitError::Kind::StreamFilter, 0, 0,
+              "PDF stream filter " + std::string(filters[i - 1]) +
+                  " hides a " + std::string(filters[i]) + " stage");
+        }
+        stages = i + 1;
+      }
+      decodable = decodable && kind != Filter::Other;
+    }
+    if (needContent && decodable)
+      stages = filters.size();
+
+    std::string output;
+    for (size_t i = 0; i < stages; ++i) {
+      bool last = i + 1 == stages;
+      bool retain = !last || needContent;
+      output.clear();
+      switch (filterKind(filters[i])) {
+      case Filter::Flate:
+        inflateBudgeted(data, retain ? &output : nullptr);
+        break;
+      case Filter::Lzw:
+        decodeLzw(data, dict, retain ? &output : nullptr);
+        break;
+      case Filter::AsciiHex:
+        decodeAsciiHex(data, output);
+        break;
+      case Filter::Ascii85:
+        decodeAscii85(data, output);
+        break;
+      case Filter::RunLength:
+        decodeRunLength(data, output);
+        break;
+      case Filter::Other:
+        break; // Not reached: the chain stops before it
+      }
+      buffer.swap(output);
+      data = buffer;
+    }
+    return stages == filters.size();
+  }
+
+  // Count bytes produced by an expanding stage against both budgets
+  void account(size_t &streamBytes, size_t produced) {
+    streamBytes += produced;
+    stats_.decompressedBytes += produced;
+
+    if (limits_.maxStreamBytes && streamBytes > limits_.maxStreamBytes) {
+      throw ResourceLimitError(ResourceLimitError::Kind::StreamBytes,
+                               limits_.maxStreamBytes, streamBytes,
+                               "Decompressed stream exceeds limit");
+    }
+    if (limits_.maxDocumentBytes &&
+        stats_.decompressedBytes > limits_.maxDocumentBytes) {
+      throw ResourceLimitError(ResourceLimitError::Kind::DocumentBytes,
+                               limits_.maxDocumentBytes,
+                               stats_.decompressedBytes,
+                               "Decompressed document exceeds limit");
+    }
+  }
+
+  // The 'z' shorthand turns one byte into four
+  void decodeAscii85(std::string_view in, std::string &out) {
+    size_t streamBytes = 0;
+    uint32_t group = 0;
+    int count = 0;
+    for (char c : in) {
+      if (c == '~')
+        break;
+      if (c == 'z' && count == 0) {
+        account(streamBytes, 4);
+        out.append(4, '\0');
+        continue;
+      }
+      if (c < '!' || c > 'u')
+        continue;
+      group = group * 85 + static_cast<uint32_t>(c - '!');
+      if (++count == 5) {
+        account(streamBytes, 4);
+        for (int shift = 24; shift >= 0; shift -= 8)
+          out += static_cast<char>(group >> shift);
+        group = 0;
+        count = 0;
+      }
+    }
+    if (count > 1) {
+      account(streamBytes, static_cast<size_t>(count - 1));
+      for (int i = count; i < 5; ++i)
+        group = group * 85 + 84; // Pad with 'u'
+      for (int i = 0; i < count - 1; ++i)
+        out += static_cast<char>(group >> (24 - 8 * i));
+    }
+  }
+
+  // Codes of 9 to 12 bits, each naming a string of up to 4096 bytes;
+  // entries hold a prefix code and a final byte, strings are rebuilt
+  // backwards into a scratch buffer
+  void decodeLzw(std::string_view in, std::string_view dict,
+                 std::string *retained) {
+    size_t early = 1;
+    intValue(dict, "/EarlyChange", early);
+    early = early ? 1 : 0;
+
+    struct Entry {
+      uint16_t prefix;
+      uint8_t last;
+      uint16_t length;
+    };
+    std::vector<Entry> table(4096);
+    for (unsigned c = 0; c < 256; ++c)
+      table[c] = {0, static_cast<uint8_t>(c), 1};
+    char scratch[4096];
+
+    size_t streamBytes = 0;
+    size_t pos = 0;
+    uint32_t bits = 0;
+    int bitCount = 0;
+    unsigned width = 9, next = 258;
+    int prev = -1;
+    while (true) {
+      while (bitCount < static_cast<int>(width) && pos < in.size()) {
+        bits = bits << 8 | static_cast<unsigned char>(in[pos++]);
+        bitCount += 8;
+      }
+      if (bitCount < static_cast<int>(width))
+        break;
+      unsigned code = bits >> (bitCount - width) & ((1u << width) - 1);
+      bitCount -= width;
+
+      if (code == 257)
+        break; // End of data
+      if (code == 256) {
+        width = 9;
+        next = 258;
+        prev = -1;
+        continue;
+      }
+      if (code > next || (code == next && prev < 0))
+        break; // Corrupt: left for poppler to report
+
+      // The KwKwK case names the entry about to be added
+      unsigned base = code == next ? static_cast<unsigned>(prev) : code;
+      size_t length = table[base].length;
+      unsigned c = base;
+      for (size_t i = length; i > 0; c = table[c].prefix)
+        scratch[--i] = static_cast<char>(table[c].last);
+      if (code == next)
+        scratch[length++] = scratch[0];
+
+      if (prev >= 0 && next < 4096) {
+        table[next] = {static_cast<uint16_t>(prev),
+                       static_cast<uint8_t>(scratch[0]),
+                       static_cast<uint16_t>(table[prev].length + 1)};
+        ++next;
+        if (next + early >= (1u << width) && width < 12)
+          ++width;
+      }
+      prev = static_cast<int>(code);
+
+      account(streamBytes, length);
+      if (retained)
+        retained->append(scratch, length);
+    }
+  }
+
+  // Runs of up to 128 copies per two input bytes
+  void decodeRunLength(std::string_view in, std::string &out) {
+    size_t streamBytes = 0;
+    size_t pos = 0;
+    while (pos < in.size()) {
+      auto length = static_cast<unsigned char>(in[pos++]);
+      if (length == 128)
+        break; // End of data
+      if (length < 128) {
+        size_t n = std::min<size_t>(length + 1, in.size() - pos);
+        account(streamBytes, n);
+        out.append(in.substr(pos, n));
+        pos += n;
+      } else if (pos < in.size()) {
+        account(streamBytes, 257 - length);
+        out.append(257 - length, in[pos++]);
+      }
+    }
+  }
+
+  // Objects packed inside an /ObjStm still count, and may be /Pages nodes.
+  void scanObjectStream(std::string_view dict, std::string_view content) {
+    size_t n = 0, first = 0;
+    if (!intValue(dict, "/N", n) || !intValue(dict, "/First", first))
+      return;
+    countObjects(n);
+    if (first > content.size())
+      return;
+
+    std::vector<std::pair<size_t, size_t>> entries;
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i) {
+      size_t num, offset;
+      pos = skipWhitespace(content, pos);
+      if (!parseUnsigned(content, pos, num))
+        break;
+      pos = skipWhitespace(content, pos);
+      if (!parseUnsigned(content, pos, offset))
+        break;
+      entries.emplace_back(num, offset);
+    }
+
+    std::string_view objects = content.substr(first);
+    for (size_t i = 0; i < entries.size(); ++i) {
+      size_t begin = entries[i].second;
+      size_t end =
+          i + 1 < entries.size() ? entries[i + 1].second : objects.size();
+      if (begin >= end || end > objects.size())
+        continue;
+      notePageNode(entries[i].first, objects.substr(begin, end - begin));
+    }
+  }
+
+  void inflateBudgeted(std::string_view data, std::string *retained) {
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK)
+      return;
+
+    unsigned char window[INFLATE_WINDOW];
+    size_t fed = 0; // Input is fed in pieces: avail_in is 32-bit
+    size_t streamBytes = 0;
+    int status = Z_OK;
+
+    try {
+      while (status == Z_OK) {
+        if (zs.avail_in == 0 && fed < data.size()) {
+          size_t piece = std::min<size_t>(data.size() - fed,
+                                          std::numeric_limits<uInt>::max());
+          zs.next_in =
+              reinterpret_cast<Bytef *>(const_cast<char *>(data.data() + fed));
+          zs.avail_in = static_cast<uInt>(piece);
+          fed += piece;
+        }
+
+        zs.next_out = window;
+        zs.avail_out = sizeof(window);
+        status = inflate(&zs, Z_NO_FLUSH);
+        size_t produced = sizeof(window) - zs.avail_out;
+        if (produced == 0 && status == Z_OK && zs.avail_in == 0 &&
+            fed == data.size())
+          break; // No progress: truncated input
+        account(streamBytes, produced);
+        if (retained)
+          retained->append(reinterpret_cast<char *>(window), produced);
+      }
+    } catch (...) {
+      inflateEnd(&zs);
+      throw;
+    }
+
+    // Corrupt streams are left for poppler to report
+    inflateEnd(&zs);
+  }
+
+  void checkPageTree() {
+    enum State : char { Unvisited, Active, Done };
+    std::unordered_map<size_t, State> state;
+    std::unordered_map<size_t, int> depth;
+    int limit = limits_.maxPageTreeDepth;
+
+    for (const auto &[root, unused] : pageNodes_) {
+      if (state[root] == Done)
+        continue;
+
+      // Iterative post-order DFS: hostile trees must not blow our stack
+      std::vector<std::pair<size_t, size_t>> stack = {{root, 0}};
+      state[root] = Active;
+
+      while (!stack.empty()) {
+        auto &[node, nextKid] = stack.back();
+        const auto &kids = pageNodes_[node];
+
+        if (nextKid < kids.size()) {
+          size_t kid = kids[nextKid++];
+          if (!pageNodes_.count(kid))
+            continue; // Leaf /Page
+          if (state[kid] == Active) {
+            throw ResourceLimitError(ResourceLimitError::Kind::PageTreeDepth,
+                                     limit, static_cast<size_t>(limit) + 1,
+                                     "PDF page tree contains a cycle");
+          }
+          if (state[kid] == Unvisited) {
+            state[kid] = Active;
+            stack.emplace_back(kid, 0);
+            if (limit > 0 && static_cast<int>(stack.size()) > limit) {
+              throw ResourceLimitError(ResourceLimitError::Kind::PageTreeDepth,
+                                       limit, stack.size(),
+                                       "PDF page tree depth exceeds limit");
+            }
+          }
+          continue;
+        }
+
+        int d = 1;
+        for (size_t kid : kids) {
+          auto it = depth.find(kid);
+          if (it != depth.end())
+            d = std::max(d, it->second + 1);
+        }
+        if (limit > 0 && d > limit) {
+          throw ResourceLimitError(ResourceLimitError::Kind::PageTreeDepth,
+                                   limit, d,
+                                   "PDF page tree depth exceeds limit");
+        }
+        depth[node] = d;
+        state[node] = Done;
+        stats_.pageTreeDepth = std::max(stats_.pageTreeDepth, d);
+        stack.pop_back();
+      }
+    }
+  }
+};
+
+} // namespace
+
+ResourceLimitError::ResourceLimitError(Kind kind, size_t limit,
+                                       size_t observed,
+                                       const std::string &message)
+    : std::runtime_error(message + " (" + kindName(kind) +
+                         ": limit=" + std::to_string(limit) +
+                         ", observed=" + std::to_string(observed) + ")"),
+      kind_(kind), limit_(limit), observed_(observed) {}
+
+const char *ResourceLimitError::kindName(Kind kind) {
+  switch (kind) {
+  case Kind::StreamBytes:
+    return "stream_bytes";
+  case Kind::DocumentBytes:
+    return "document_bytes";
+  case Kind::ObjectCount:
+    return "object_count";
+  case Kind::PageTreeDepth:
+    return "page_tree_depth";
+  case Kind::PageTextBytes:
+    return "page_text_bytes";
+  case Kind::StreamFilter:
+    return "stream_filter";
+  case Kind::Encrypted:
+    return "encrypted";
+  }
+  return "unknown";
+}
+
+ResourceGuard::ResourceGuard(const ResourceLimits &limits) : limits_(limits) {
+  stats_ = {0, 0, 0, 0};
+}
+
+void ResourceGuard::scan(const char *data, size_t size) {
+  stats_ = {0, 0, 0, 0};
+  Scanner scanner(limits_, stats_);
+  scanner.run(std::string_view(data, size));
+}
+
+void ResourceGuard::checkPageText(int pageIndex, size_t bytes) const {
+  if (limits_.maxPageTextBytes && bytes > limits_.maxPageTextBytes) {
+    throw ResourceLimitError(ResourceLimitError::Kind::PageTextBytes,
+                             limits_.maxPageTextBytes, bytes,
+                             "Extracted text of page " +
+                                 std::to_string(pageIndex + 1) +
+                                 " exceeds limit");
+  }
+}
+
+} // namespace guardian
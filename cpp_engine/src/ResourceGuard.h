@@ -0,0 +1,99 @@
+#ifndef RESOURCE_GUARD_H
+#define RESOURCE_GUARD_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace guardian {
+
+/**
+ * ResourceLimits - Budgets enforced on every document we parse
+ *
+ * A value of 0 disables the corresponding limit.
+ */
+struct ResourceLimits {
+  size_t maxStreamBytes = 64u << 20;    // Decompressed bytes per stream
+  size_t maxDocumentBytes = 256u << 20; // Decompressed bytes per document
+  size_t maxObjects = 500000;           // Indirect objects (incl. ObjStm)
+  int maxPageTreeDepth = 64;            // Nesting of /Pages nodes
+  size_t maxPageTextBytes = 4u << 20;   // Extracted UTF-8 bytes per page
+};
+
+/**
+ * ResourceLimitError - Thrown when a document exceeds a ResourceLimits budget
+ */
+class ResourceLimitError : public std::runtime_error {
+public:
+  enum class Kind {
+    StreamBytes,
+    DocumentBytes,
+    ObjectCount,
+    PageTreeDepth,
+    PageTextBytes,
+    StreamFilter, // A filter chain that cannot be decoded to be checked
+    Encrypted     // Encrypted streams cannot be decoded to be checked
+  };
+
+  ResourceLimitError(Kind kind, size_t limit, size_t observed,
+                     const std::string &message);
+
+  Kind kind() const { return kind_; }
+  size_t limit() const { return limit_; }
+  size_t observed() const { return observed_; }
+
+  static const char *kindName(Kind kind);
+
+private:
+  Kind kind_;
+  size_t limit_;
+  size_t observed_;
+};
+
+/**
+ * ResourceGuard - Pre-flight scan of raw PDF bytes
+ *
+ * Walks the object table, decodes the filter chain of every stream up to
+ * its last FlateDecode or LZWDecode stage, decoding into a fixed-size
+ * scratch window (nothing is retained except the input of later stages
+ * and object streams, which are needed to find compressed /Pages nodes),
+ * and aborts with a ResourceLimitError the moment a budget is crossed. A
+ * chain whose expanding stage sits behind a filter the scan cannot decode,
+ * or that is an indirect reference, is rejected, and so is an encrypted
+ * document while a byte budget is set. poppler only ever sees documents
+ * that passed this scan.
+ */
+class ResourceGuard {
+public:
+  explicit ResourceGuard(const ResourceLimits &limits = ResourceLimits());
+
+  /**
+   * Scan a complete PDF held in memory
+   * @throws ResourceLimitError if any limit is exceeded
+   */
+  void scan(const char *data, size_t size);
+
+  /**
+   * Check extracted text for a single page
+   * @throws ResourceLimitError if the page exceeds maxPageTextBytes
+   */
+  void checkPageText(int pageIndex, size_t bytes) const;
+
+  struct Stats {
+    size_t objectCount;
+    size_t streamCount;
+    size_t decompressedBytes;
+    int pageTreeDepth;
+  };
+
+  Stats getStats() const { return stats_; }
+  const ResourceLimits &getLimits() const { return limits_; }
+
+private:
+  ResourceLimits limits_;
+  Stats stats_;
+};
+
+} // namespace guardian
+
+#endif // RESOURCE_GUARD_H
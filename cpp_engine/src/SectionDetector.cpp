@@ -0,0 +1,273 @@
+#include "SectionDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace guardian {
+
+namespace {
+
+bool isAsciiDigit(unsigned char c) { return c >= '0' && c <= '9'; }
+
+bool isAsciiAlpha(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+unsigned char asciiLower(unsigned char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + 32) : c;
+}
+
+// Comparison key for titles: a leading section number ("2.1 ") and ASCII
+// punctuation are dropped, ASCII letters lower-cased, other bytes kept
+std::string titleKey(const std::string &title) {
+  size_t i = 0;
+  while (i < title.size() &&
+         (isAsciiDigit(title[i]) || title[i] == '.' || title[i] == ' '))
+    ++i;
+
+  std::string key;
+  key.reserve(title.size() - i);
+  for (; i < title.size(); ++i) {
+    unsigned char c = title[i];
+    if (c >= 0x80 || isAsciiDigit(c) || isAsciiAlpha(c))
+      key += static_cast<char>(asciiLower(c));
+  }
+  return key;
+}
+
+// Weight markers in PostScript font names ("Arial-BoldMT", "Foo,Black")
+bool isBoldName(const std::string &name) {
+  static const char *const MARKERS[] = {"bold", "black", "heavy"};
+  std::string lower(name.size(), '\0');
+  std::transform(name.begin(), name.end(), lower.begin(), [](char c) {
+    return static_cast<char>(asciiLower(static_cast<unsigned char>(c)));
+  });
+  for (const char *marker : MARKERS) {
+    if (lower.find(marker) != std::string::npos)
+      return true;
+  }
+  return false;
+}
+
+int sizeClass(float size) { return static_cast<int>(std::lround(size * 2)); }
+
+// Find a title that starts a line (headings are blocks of their own)
+size_t findLine(const std::string &text, const std::string &title,
+                size_t from) {
+  size_t pos = text.find(title, from);
+  while (pos != std::string::npos && pos > 0 && text[pos - 1] != '\n')
+    pos = text.find(title, pos + 1);
+  return pos;
+}
+
+} // namespace
+
+SectionDetector::SectionDetector(const SectionOptions &options)
+    : options_(options), titleNormalizer_(NormalizeOptions{false, false}) {}
+
+void SectionDetector::reset(const std::vector<OutlineEntry> &outline) {
+  outline_.clear();
+  for (const auto &entry : outline) {
+    std::string key = titleKey(entry.title);
+    if (!key.empty())
+      outline_.emplace(std::move(key), entry.level); // First wins
+  }
+  boldFonts_.clear();
+  candidates_.clear();
+  pageBegin_ = 0;
+}
+
+bool SectionDetector::isBold(const std::vector<std::string> &fonts,
+                             uint16_t fontId) {
+  if (fontId == PageLayout::NO_FONT || fontId >= fonts.size()) {
+    return false;
+  }
+  if (boldFonts_.size() < fonts.size()) {
+    boldFonts_.resize(fonts.size(), -1);
+  }
+  if (boldFonts_[fontId] < 0) {
+    boldFonts_[fontId] = isBoldName(fonts[fontId]) ? 1 : 0;
+  }
+  return boldFonts_[fontId] == 1;
+}
+
+void SectionDetector::detectPage(const PageLayout &page,
+                                 const std::vector<std::string> &fonts,
+                                 ReadingOrder &order) {
+  pageBegin_ = candidates_.size();
+  const size_t lineCount = order.lineStarts.size();
+  if (lineCount == 0) {
+    return;
+  }
+
+  // Body text: the most common size by characters, and whether it is bold
+  std::unordered_map<int, size_t> sizeWeights;
+  size_t boldChars = 0, totalChars = 0;
+  for (size_t i = 0; i < page.wordCount(); ++i) {
+    size_t chars = page.wordOffsets[i + 1] - page.wordOffsets[i];
+    sizeWeights[sizeClass(page.fontSizes[i])] += chars;
+    totalChars += chars;
+    if (isBold(fonts, page.fontIds[i]))
+      boldChars += chars;
+  }
+  int bodyClass = 0;
+  size_t bodyWeight = 0;
+  for (const auto &[cls, weight] : sizeWeights) {
+    if (weight > bodyWeight || (weight == bodyWeight && cls < bodyClass)) {
+      bodyClass = cls;
+      bodyWeight = weight;
+    }
+  }
+  const float minHeadingSize = bodyClass / 2.0f * options_.minSizeRatio;
+  const bool bodyBold = 2 * boldChars > totalChars;
+
+  std::vector<uint32_t> splits; // New block starts around heading lines
+  bool groupOpen = false;
+  uint32_t groupEnd = 0;
+  auto closeGroup = [&]() {
+    if (groupOpen && groupEnd < order.order.size())
+      splits.push_back(groupEnd);
+    groupOpen = false;
+  };
+
+  for (size_t l = 0; l < lineCount; ++l) {
+    uint32_t begin = order.lineStarts[l];
+    uint32_t end = l + 1 < lineCount
+                       ? order.lineStarts[l + 1]
+                       : static_cast<uint32_t>(order.order.size());
+    if (end - begin > static_cast<uint32_t>(options_.maxHeadingWords)) {
+      closeGroup();
+      continue;
+    }
+
+    // Line text (joined as XYCut::text does) and font attributes
+    std::string text;
+    float minSize = 0;
+    bool allBold = true, hasLetter = false;
+    for (uint32_t pos = begin; pos < end; ++pos) {
+      uint32_t w = order.order[pos];
+      if (pos > begin &&
+          (w != order.order[pos - 1] + 1 ||
+           (page.flags[order.order[pos - 1]] & PageLayout::SPACE_AFTER)))
+        text += ' ';
+      size_t from = page.wordOffsets[w], to = page.wordOffsets[w + 1];
+      for (size_t k = from; k < to && !hasLetter; ++k) {
+        unsigned char c = page.text[k];
+        hasLetter = isAsciiAlpha(c) || c >= 0x80;
+      }
+      text.append(page.text, from, to - from);
+      minSize = pos == begin ? page.fontSizes[w]
+                             : std::min(minSize, page.fontSizes[w]);
+      allBold = allBold && isBold(fonts, page.fontIds[w]);
+    }
+
+    auto it = outline_.find(titleKey(text));
+    int outlineLevel = it != outline_.end() ? it->second : 0;
+    bool bySize = bodyClass > 0 && minSize >= minHeadingSize;
+    bool byBold = options_.boldHeadings && allBold && !bodyBold &&
+                  !text.empty() && text.back() != '.';
+    if (!hasLetter || !(outlineLevel || bySize || byBold)) {
+      closeGroup();
+      continue;
+    }
+
+    // Continue a multi-line title within the same block
+    bool blockStart = std::binary_search(order.blockStarts.begin(),
+                                         order.blockStarts.end(), begin);
+    Candidate *last = candidates_.size() > pageBegin_ ? &candidates_.back()
+                                                      : nullptr;
+    if (groupOpen && groupEnd == begin && !blockStart && !outlineLevel &&
+        !last->outlineLevel && last->sizeClass == sizeClass(minSize)) {
+      last->heading.title += ' ';
+      last->heading.title += text;
+      groupEnd = end;
+      continue;
+    }
+
+    closeGroup();
+    Heading heading;
+    heading.title = std::move(text);
+    heading.page = page.pageIndex;
+    candidates_.push_back(
+        {std::move(heading), sizeClass(minSize), !bySize, outlineLevel});
+    splits.push_back(begin);
+    groupOpen = true;
+    groupEnd = end;
+  }
+  closeGroup();
+
+  if (!splits.empty()) {
+    order.blockStarts.insert(order.blockStarts.end(), splits.begin(),
+                             splits.end());
+    std::sort(order.blockStarts.begin(), order.blockStarts.end());
+    order.blockStarts.erase(
+        std::unique(order.blockStarts.begin(), order.blockStarts.end()),
+        order.blockStarts.end());
+  }
+}
+
+void SectionDetector::locatePage(const std::string &text) {
+  size_t cursor = 0;
+  for (size_t i = pageBegin_; i < candidates_.size(); ++i) {
+    Heading &heading = candidates_[i].heading;
+    std::string normalized = heading.title;
+    titleNormalizer_.normalize(normalized);
+
+    size_t pos = findLine(text, normalized, cursor);
+    if (pos != std::string::npos) {
+      heading.title = std::move(normalized);
+    } else {
+      pos = findLine(text, heading.title, cursor); // Normalization disabled
+    }
+
+    if (pos == std::string::npos) {
+      heading.page = -1; // Not found: dropped below
+      continue;
+    }
+    heading.offset = pos;
+    cursor = pos + heading.title.size();
+  }
+
+  candidates_.erase(std::remove_if(candidates_.begin() + pageBegin_,
+                                   candidates_.end(),
+                                   [](const Candidate &c) {
+                                     return c.heading.page < 0;
+                                   }),
+                    candidates_.end());
+}
+
+std::vector<Heading> SectionDetector::finish() {
+  // Rank the font sizes of headings set in a larger size, largest first
+  std::vector<int> classes;
+  for (const auto &c : candidates_) {
+    if (!c.bold)
+      classes.push_back(c.sizeClass);
+  }
+  std::sort(classes.begin(), classes.end(), std::greater<int>());
+  classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+
+  std::vector<Heading> headings;
+  headings.reserve(candidates_.size());
+  for (auto &c : candidates_) {
+    int level;
+    if (c.outlineLevel) {
+      level = c.outlineLevel;
+    } else if (c.bold) {
+      level = static_cast<int>(classes.size()) + 1;
+    } else {
+      level = static_cast<int>(
+                  std::lower_bound(classes.begin(), classes.end(), c.sizeClass,
+                                   std::greater<int>()) -
+                  classes.begin()) +
+              1;
+    }
+    c.heading.level = std::min(level, options_.maxLevel);
+    headings.push_back(std::move(c.heading));
+  }
+
+  candidates_.clear();
+  pageBegin_ = 0;
+  return headings;
+}
+
+} // namespace guardian
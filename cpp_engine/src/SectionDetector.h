@@ -0,0 +1,120 @@
+#ifndef SECTION_DETECTOR_H
+#define SECTION_DETECTOR_H
+
+#include "PageLayout.h"
+#include "TableDetector.h"
+#include "TextNormalizer.h"
+#include "XYCut.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * OutlineEntry - One PDF bookmark, flattened in document order
+ */
+struct OutlineEntry {
+  int level; // 1 = top level
+  std::string title;
+};
+
+/**
+ * Heading - A detected section heading
+ */
+struct Heading {
+  int level = 1; // 1 = top level
+  std::string title;
+  int page = 0;
+  size_t offset = 0; // Byte offset of the title in the page's text
+};
+
+/**
+ * StructuredText - Page texts together with their section headings and
+ * the tables taken out of them
+ */
+struct StructuredText {
+  std::vector<std::string> pages;
+  std::vector<Heading> headings; // In document order
+  std::vector<Table> tables;     // In page order
+};
+
+/**
+ * SectionOptions - Heading detection thresholds
+ */
+struct SectionOptions {
+  float minSizeRatio = 1.15f; // Font size relative to the page's body text
+  int maxHeadingWords = 12;   // Longer lines are never headings
+  bool boldHeadings = true;   // Accept bold lines at body size
+  int maxLevel = 6;
+};
+
+/**
+ * SectionDetector - Heading detection from font statistics and outline
+ *
+ * Runs per page during extraction, on the words already in reading order:
+ *  - the body size is the most common font size on the page, weighted by
+ *    characters;
+ *  - a short line is a heading if its font is at least minSizeRatio times
+ *    the body size, if it is entirely bold (font name) while body text is
+ *    not, or if it matches a bookmark title;
+ *  - consecutive heading lines of one block with the same size merge into
+ *    one multi-line title.
+ *
+ * Heading lines are made blocks of their own so they survive line joining,
+ * and are then located in the final (normalized) page text. Levels are
+ * assigned when the document is finished: bookmark depth where a title
+ * matched the outline, otherwise the rank of the heading's font size, with
+ * bold body-size headings deepest.
+ */
+class SectionDetector {
+public:
+  explicit SectionDetector(const SectionOptions &options = SectionOptions());
+
+  /**
+   * Start a new document
+   * @param outline Flattened bookmarks (may be empty)
+   */
+  void reset(const std::vector<OutlineEntry> &outline);
+
+  /**
+   * Find the heading lines of a page and split them into their own blocks
+   * @param page Words with font attributes
+   * @param fonts Font names indexed by the page's font ids
+   * @param order Reading order of the page; block starts are added
+   */
+  void detectPage(const PageLayout &page, const std::vector<std::string> &fonts,
+                  ReadingOrder &order);
+
+  /**
+   * Locate the headings of the last detected page in its final text.
+   * Headings that cannot be found are dropped.
+   */
+  void locatePage(const std::string &text);
+
+  /**
+   * Assign levels and return all headings of the document
+   */
+  std::vector<Heading> finish();
+
+private:
+  struct Candidate {
+    Heading heading;
+    int sizeClass;    // Font size in half points
+    bool bold;
+    int outlineLevel; // 0 if not in the outline
+  };
+
+  SectionOptions options_;
+  TextNormalizer titleNormalizer_;
+  std::unordered_map<std::string, int> outline_; // Title key -> level
+  std::vector<int8_t> boldFonts_;                // -1 = not yet classified
+  std::vector<Candidate> candidates_;
+  size_t pageBegin_ = 0; // First candidate of the last detected page
+
+  bool isBold(const std::vector<std::string> &fonts, uint16_t fontId);
+};
+
+} // namespace guardian
+
+#endif // SECTION_DETECTOR_H
@@ -0,0 +1,130 @@
+#include "StreamingChunker.h"
+#include "TextChunker.h"
+#include <algorithm>
+
+namespace guardian {
+
+StreamingChunker::StreamingChunker(int chunkSize, int overlapSize,
+                                   Callback callback)
+    : chunkSize_(chunkSize), overlapSize_(overlapSize),
+      callback_(std::move(callback)) {
+  TextChunker::validate(chunkSize, overlapSize);
+}
+
+void StreamingChunker::feed(const char *data, size_t size) {
+  // Only words followed by whitespace are complete
+  size_t cut = size;
+  while (cut > 0 && !Tokenizer::isSpace(data[cut - 1]))
+    --cut;
+
+  if (cut > 0) {
+    if (carry_.empty()) {
+      addWords(data, cut);
+    } else {
+      carry_.append(data, cut);
+      addWords(carry_.data(), carry_.size());
+      carry_.clear();
+    }
+  }
+  carry_.append(data + cut, size - cut);
+
+  // Only a byte >= 0x80 can start or complete a code point of a script
+  // written without spaces
+  if (std::any_of(data + cut, data + size,
+                  [](char c) { return static_cast<unsigned char>(c) >= 0x80; }))
+    cutRun();
+  stats_.maxWindowBytes =
+      std::max(stats_.maxWindowBytes, window_.size() + carry_.size());
+}
+
+// Inside a run without whitespace every token but the last is complete:
+// a later code point can only extend the last one. A trailing incomplete
+// UTF-8 sequence is left out first, as it would tokenize on its own.
+void StreamingChunker::cutRun() {
+  size_t end = carry_.size();
+  for (size_t back = 1; back <= 3 && back <= carry_.size(); ++back) {
+    auto c = static_cast<unsigned char>(carry_[carry_.size() - back]);
+    if ((c & 0xC0) == 0x80)
+      continue;
+    size_t need = c < 0xC0 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    if (need > back)
+      end = carry_.size() - back;
+    break;
+  }
+
+  scratch_.clear();
+  Tokenizer::split(carry_.data(), end, scratch_);
+  if (scratch_.size() < 2)
+    return;
+  size_t last = scratch_.back().first;
+  // An ideographic space between the words is a gap, as in join()
+  bool adjacent = scratch_[scratch_.size() - 2].second == last;
+  addWords(carry_.data(), last);
+  carry_.erase(0, last);
+  glued_ = adjacent;
+}
+
+void StreamingChunker::addWords(const char *data, size_t size) {
+  scratch_.clear();
+  Tokenizer::split(data, size, scratch_);
+
+  for (size_t i = 0; i < scratch_.size(); ++i) {
+    const auto &[begin, end] = scratch_[i];
+    // A piece follows a gap unless it was cut inside a run
+    bool gap = i == 0 ? begin > 0 || !glued_ : begin > scratch_[i - 1].second;
+    if (!words_.empty() && gap)
+      window_ += ' ';
+    words_.emplace_back(window_.size(), window_.size() + end - begin);
+    window_.append(data + begin, end - begin);
+    stats_.maxWindowBytes = std::max(stats_.maxWindowBytes, window_.size());
+
+    // A full window is emitted once a word beyond it shows it is not last
+    if (words_.size() > static_cast<size_t>(chunkSize_)) {
+      emit(chunkSize_);
+      size_t stride = chunkSize_ - overlapSize_;
+      size_t offset = words_[stride].first;
+      window_.erase(0, offset);
+      words_.erase(words_.begin(), words_.begin() + stride);
+      for (auto &span : words_) {
+        span.first -= offset;
+        span.second -= offset;
+      }
+      covered_ = overlapSize_;
+    }
+  }
+  stats_.words += scratch_.size();
+  glued_ = false;
+}
+
+void StreamingChunker::emit(size_t count) {
+  std::string_view chunk(window_.data() + words_[0].first,
+                         words_[count - 1].second - words_[0].first);
+  ++stats_.chunks;
+  if (callback_) {
+    callback_(chunk);
+  } else {
+    ready_.emplace_back(chunk);
+  }
+}
+
+void StreamingChunker::flush() {
+  if (!carry_.empty()) {
+    addWords(carry_.data(), carry_.size());
+    carry_.clear();
+  }
+  // The tail is a chunk unless the previous chunk already reached it
+  if (words_.size() > covered_) {
+    emit(words_.size());
+  }
+  window_.clear();
+  words_.clear();
+  covered_ = 0;
+}
+
+std::vector<std::string> StreamingChunker::takeChunks() {
+  std::vector<std::string> chunks;
+  chunks.swap(ready_);
+  return chunks;
+}
+
+} // namespace guardian
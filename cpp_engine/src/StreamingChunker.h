@@ -0,0 +1,86 @@
+#ifndef STREAMING_CHUNKER_H
+#define STREAMING_CHUNKER_H
+
+#include "Tokenizer.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * StreamingChunker - Push-based chunking with a bounded word window
+ *
+ * Text is fed in pieces of any size (a word or a UTF-8 sequence may be
+ * split across pieces). A chunk is emitted as soon as one word beyond it
+ * has arrived, so at most chunkSize + 1 words are held, plus the
+ * unfinished word at the end of the last piece (in scripts written
+ * without spaces, the last character or cluster). flush() ends the stream:
+ * the chunks of everything fed since the previous flush are exactly
+ * TextChunker(chunkSize, overlapSize).chunk() of the concatenated pieces.
+ *
+ * Chunks go to the callback if one is given, as a view that is valid
+ * until the callback returns; otherwise they are queued as strings and
+ * read with takeChunks().
+ */
+class StreamingChunker {
+public:
+  using Callback = std::function<void(std::string_view)>;
+
+  struct Stats {
+    size_t words;          // Words fed since construction
+    size_t chunks;         // Chunks emitted
+    size_t maxWindowBytes; // Most bytes held (window and unfinished word)
+  };
+
+  /**
+   * @param chunkSize Target number of words per chunk
+   * @param overlapSize Number of overlapping words between chunks
+   * @param callback Receives each chunk; none = queue them
+   * @throws std::invalid_argument unless 0 <= overlapSize < chunkSize
+   */
+  explicit StreamingChunker(int chunkSize = 500, int overlapSize = 50,
+                            Callback callback = nullptr);
+
+  /**
+   * Add the next piece of text
+   */
+  void feed(const char *data, size_t size);
+  void feed(const std::string &piece) { feed(piece.data(), piece.size()); }
+
+  /**
+   * End the stream: emit the last chunk and start a new stream
+   */
+  void flush();
+
+  /**
+   * Chunks emitted so far without a callback, oldest first
+   */
+  std::vector<std::string> takeChunks();
+
+  Stats getStats() const { return stats_; }
+
+private:
+  int chunkSize_;
+  int overlapSize_;
+  Callback callback_;
+  std::vector<std::string> ready_;
+
+  // Window words joined as TextChunker joins them, with their spans
+  std::string window_;
+  std::vector<Tokenizer::Span> words_;
+  size_t covered_ = 0; // Leading words already in an emitted chunk
+  std::string carry_;  // Unfinished word at the end of the last piece
+  bool glued_ = false; // carry_ continues a run without a gap
+  std::vector<Tokenizer::Span> scratch_;
+  Stats stats_{};
+
+  void addWords(const char *data, size_t size);
+  void cutRun();
+  void emit(size_t count);
+};
+
+} // namespace guardian
+
+#endif // STREAMING_CHUNKER_H
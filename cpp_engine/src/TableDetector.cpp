@@ -0,0 +1,298 @@
+#include "TableDetector.h"
+#include <algorithm>
+
+namespace guardian {
+
+namespace {
+
+constexpr uint8_t ROTATION_MASK = 3 << PageLayout::ROTATION_SHIFT;
+
+struct WordBox {
+  float x0, y0, x1, y1;
+  uint32_t index;
+};
+
+// A cell is a run of words [begin, end) of the line-sorted word array
+struct Cell {
+  float x0, x1;
+  size_t begin, end;
+};
+
+struct Line {
+  float y0, y1;
+  size_t cellBegin, cellEnd;
+};
+
+using Column = std::pair<float, float>;
+
+// Column of each cell, or an empty vector if the line does not fit: every
+// cell must overlap exactly one column, in left-to-right order
+std::vector<int> fitColumns(const std::vector<Cell> &cells, const Line &line,
+                            const std::vector<Column> &columns) {
+  std::vector<int> assignment;
+  int previous = -1;
+  for (size_t c = line.cellBegin; c < line.cellEnd; ++c) {
+    int match = -1;
+    for (size_t k = 0; k < columns.size(); ++k) {
+      if (cells[c].x0 < columns[k].second && cells[c].x1 > columns[k].first) {
+        if (match >= 0)
+          return {};
+        match = static_cast<int>(k);
+      }
+    }
+    if (match <= previous)
+      return {};
+    assignment.push_back(match);
+    previous = match;
+  }
+  return assignment;
+}
+
+std::string cellText(const PageLayout &page, const std::vector<WordBox> &words,
+                     const Cell &cell) {
+  std::string text;
+  for (size_t i = cell.begin; i < cell.end; ++i) {
+    uint32_t w = words[i].index;
+    if (i > cell.begin) {
+      uint32_t prev = words[i - 1].index;
+      if (w != prev + 1 || (page.flags[prev] & PageLayout::SPACE_AFTER))
+        text += ' ';
+    }
+    text.append(page.text, page.wordOffsets[w],
+                page.wordOffsets[w + 1] - page.wordOffsets[w]);
+  }
+  return text;
+}
+
+// Noncharacter U+FDD0 + k, encoded as EF B7 (90 + k)
+bool isAnchor(const std::string &text, size_t pos, size_t &k) {
+  if (pos + 3 > text.size() || static_cast<unsigned char>(text[pos]) != 0xEF ||
+      static_cast<unsigned char>(text[pos + 1]) != 0xB7) {
+    return false;
+  }
+  unsigned char last = static_cast<unsigned char>(text[pos + 2]);
+  if (last < 0x90 || last >= 0x90 + TableDetector::MAX_ANCHORS) {
+    return false;
+  }
+  k = last - 0x90;
+  return true;
+}
+
+} // namespace
+
+TableDetector::TableDetector(const TableOptions &options)
+    : options_(options) {}
+
+std::vector<Table> TableDetector::detect(PageLayout &page) const {
+  std::vector<Table> tables;
+  const size_t n = page.wordCount();
+
+  std::vector<WordBox> words;
+  std::vector<float> heights;
+  words.reserve(n);
+  heights.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    if (page.flags[i] & ROTATION_MASK)
+      continue;
+    const float *b = &page.boxes[4 * i];
+    words.push_back({b[0], b[1], b[2], b[3], static_cast<uint32_t>(i)});
+    heights.push_back(b[3] - b[1]);
+  }
+  if (words.size() <
+      static_cast<size_t>(options_.minRows) * options_.minColumns) {
+    return tables;
+  }
+
+  auto mid = heights.begin() + heights.size() / 2;
+  std::nth_element(heights.begin(), mid, heights.end());
+  const float unit = *mid > 0 ? *mid : 1.0f;
+  const float cellGap = options_.minCellGap * unit;
+  const float rowGap = options_.maxRowGap * unit;
+
+  // Visual lines (by vertical centre), each split into cells at wide gaps
+  std::sort(words.begin(), words.end(), [](const WordBox &a, const WordBox &b) {
+    return a.y0 + a.y1 < b.y0 + b.y1;
+  });
+  std::vector<Cell> cells;
+  std::vector<Line> lines;
+  for (size_t begin = 0; begin < words.size();) {
+    size_t end = begin + 1;
+    while (end < words.size() &&
+           (words[end].y0 + words[end].y1) / 2 <= words[begin].y1)
+      ++end;
+    std::sort(words.begin() + begin, words.begin() + end,
+              [](const WordBox &a, const WordBox &b) { return a.x0 < b.x0; });
+
+    Line line{words[begin].y0, words[begin].y1, cells.size(), 0};
+    Cell cell{words[begin].x0, words[begin].x1, begin, begin + 1};
+    for (size_t i = begin + 1; i < end; ++i) {
+      line.y0 = std::min(line.y0, words[i].y0);
+      line.y1 = std::max(line.y1, words[i].y1);
+      if (words[i].x0 - cell.x1 >= cellGap) {
+        cells.push_back(cell);
+        cell = {words[i].x0, words[i].x1, i, i + 1};
+      } else {
+        cell.x1 = std::max(cell.x1, words[i].x1);
+        cell.end = i + 1;
+      }
+    }
+    cells.push_back(cell);
+    line.cellEnd = cells.size();
+    lines.push_back(line);
+    begin = end;
+  }
+
+  // Runs of adjacent lines whose cells line up in columns
+  for (size_t i = 0; i < lines.size();) {
+    if (lines[i].cellEnd - lines[i].cellBegin < 2) {
+      ++i;
+      continue;
+    }
+
+    std::vector<Column> columns;
+    std::vector<std::vector<int>> assignments(1);
+    for (size_t c = lines[i].cellBegin; c < lines[i].cellEnd; ++c) {
+      columns.emplace_back(cells[c].x0, cells[c].x1);
+      assignments[0].push_back(static_cast<int>(columns.size()) - 1);
+    }
+    size_t cellCount = columns.size();
+
+    size_t j = i + 1;
+    for (; j < lines.size(); ++j) {
+      if (lines[j].cellEnd - lines[j].cellBegin < 2 ||
+          lines[j].y0 - lines[j - 1].y1 > rowGap) {
+        break;
+      }
+      std::vector<int> fit = fitColumns(cells, lines[j], columns);
+      if (fit.empty()) {
+        break;
+      }
+      for (size_t c = lines[j].cellBegin; c < lines[j].cellEnd; ++c) {
+        Column &column = columns[fit[c - lines[j].cellBegin]];
+        column.first = std::min(column.first, cells[c].x0);
+        column.second = std::max(column.second, cells[c].x1);
+      }
+      cellCount += fit.size();
+      assignments.push_back(std::move(fit));
+    }
+
+    size_t wordCount = cells[lines[j - 1].cellEnd - 1].end -
+                       cells[lines[i].cellBegin].begin;
+    if (j - i < static_cast<size_t>(options_.minRows) ||
+        columns.size() < static_cast<size_t>(options_.minColumns) ||
+        wordCount > options_.maxCellWords * cellCount) {
+      ++i;
+      continue;
+    }
+
+    Table table;
+    table.page = page.pageIndex;
+    table.rows = static_cast<int>(j - i);
+    table.columns = static_cast<int>(columns.size());
+    table.box[0] = columns.front().first;
+    table.box[1] = lines[i].y0;
+    table.box[2] = columns.back().second;
+    table.box[3] = lines[j - 1].y1;
+
+    std::vector<std::vector<std::string>> grid(
+        j - i, std::vector<std::string>(columns.size()));
+    for (size_t r = i; r < j; ++r) {
+      const std::vector<int> &fit = assignments[r - i];
+      for (size_t c = lines[r].cellBegin; c < lines[r].cellEnd; ++c) {
+        grid[r - i][fit[c - lines[r].cellBegin]] =
+            cellText(page, words, cells[c]);
+        for (size_t w = cells[c].begin; w < cells[c].end; ++w)
+          page.flags[words[w].index] |= PageLayout::IN_TABLE;
+      }
+    }
+    table.text = serialize(grid, options_.format);
+    tables.push_back(std::move(table));
+    i = j;
+  }
+
+  return tables;
+}
+
+void TableDetector::addAnchors(PageLayout &page,
+                               const std::vector<Table> &tables) {
+  const size_t count = std::min(tables.size(), MAX_ANCHORS);
+  for (size_t k = 0; k < count; ++k) {
+    const char anchor[3] = {'\xEF', '\xB7', static_cast<char>(0x90 + k)};
+    const float *b = tables[k].box;
+    page.addWord(anchor, 3, b[0], b[1], b[2], b[3], 0, PageLayout::NO_FONT, 0);
+  }
+}
+
+void TableDetector::takeAnchors(std::string &text, std::vector<Table> &tables) {
+  std::vector<bool> anchored(tables.size(), false);
+  size_t pos = 0;
+  while ((pos = text.find('\xEF', pos)) != std::string::npos) {
+    size_t k;
+    if (!isAnchor(text, pos, k)) {
+      ++pos;
+      continue;
+    }
+
+    // Replace the anchor and the whitespace around it by a paragraph break
+    auto isBreak = [](char c) { return c == '\n' || c == ' '; };
+    size_t end = pos + 3;
+    while (end < text.size() && isBreak(text[end]))
+      ++end;
+    while (pos > 0 && isBreak(text[pos - 1]))
+      --pos;
+    if (pos == 0 || end == text.size()) {
+      text.erase(pos, end - pos);
+    } else {
+      text.replace(pos, end - pos, "\n\n");
+      pos += 2;
+    }
+
+    if (k < tables.size()) {
+      tables[k].offset = pos;
+      anchored[k] = true;
+    }
+  }
+
+  for (size_t k = 0; k < tables.size(); ++k) {
+    if (!anchored[k])
+      tables[k].offset = text.size();
+  }
+}
+
+std::string
+TableDetector::serialize(const std::vector<std::vector<std::string>> &rows,
+                         TableFormat format) {
+  std::string out;
+  for (size_t r = 0; r < rows.size(); ++r) {
+    if (format == TableFormat::Markdown) {
+      out += '|';
+      for (const std::string &cell : rows[r]) {
+        out += ' ';
+        for (char c : cell) {
+          if (c == '|')
+            out += "\\|";
+          else
+            out += c == '\n' || c == '\t' ? ' ' : c;
+        }
+        out += " |";
+      }
+      if (r == 0) {
+        out += "\n|";
+        for (size_t c = 0; c < rows[r].size(); ++c)
+          out += " --- |";
+      }
+    } else {
+      for (size_t c = 0; c < rows[r].size(); ++c) {
+        if (c > 0)
+          out += '\t';
+        for (char ch : rows[r][c])
+          out += ch == '\n' || ch == '\t' ? ' ' : ch;
+      }
+    }
+    if (r + 1 < rows.size())
+      out += '\n';
+  }
+  return out;
+}
+
+} // namespace guardian
@@ -0,0 +1,92 @@
+#ifndef TABLE_DETECTOR_H
+#define TABLE_DETECTOR_H
+
+#include "PageLayout.h"
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+enum class TableFormat { Markdown, Tsv };
+
+/**
+ * TableOptions - Table detection thresholds; gaps are multiples of the
+ * median word height
+ */
+struct TableOptions {
+  int minRows = 3;
+  int minColumns = 2;
+  float minCellGap = 1.0f;   // Horizontal gap separating cells in a row
+  float maxRowGap = 2.0f;    // Vertical gap between consecutive rows
+  float maxCellWords = 4.0f; // Average words per cell; rules out prose
+  TableFormat format = TableFormat::Markdown;
+};
+
+/**
+ * Table - A detected table, serialized as one chunk
+ */
+struct Table {
+  int page = 0;
+  size_t offset = 0; // Anchor in the page's text (where the table was)
+  int rows = 0;
+  int columns = 0;
+  float box[4] = {0, 0, 0, 0}; // [x0, y0, x1, y1] in points
+  std::string text;            // Markdown or TSV
+};
+
+/**
+ * TableDetector - Table regions from aligned word boxes
+ *
+ * Words are grouped into visual lines, and each line into cells wherever
+ * the horizontal gap is at least minCellGap. A table is a run of at least
+ * minRows vertically adjacent lines with two or more cells, where every
+ * cell of a line falls into exactly one column of the rows above (column
+ * extents grow as rows are added). Runs whose cells average more than
+ * maxCellWords words are side-by-side prose columns, not tables. Rows
+ * whose cells wrap onto a second line end the run.
+ *
+ * Detected words are flagged PageLayout::IN_TABLE so that XYCut leaves
+ * them out of the text flow. An anchor word covering the table's box can
+ * be added in their place. It is ordered like any other block and later
+ * turned into Table::offset by takeAnchors. Anchors are the Unicode
+ * noncharacters U+FDD0-U+FDEF (one per table, so tables may be read in a
+ * different order than detected), which do not occur in document text.
+ */
+class TableDetector {
+public:
+  static constexpr size_t MAX_ANCHORS = 32; // Later tables anchor at the end
+
+  explicit TableDetector(const TableOptions &options = TableOptions());
+
+  /**
+   * Detect the tables of a page and flag their words IN_TABLE
+   */
+  std::vector<Table> detect(PageLayout &page) const;
+
+  /**
+   * Append one anchor word per table to the page
+   */
+  static void addAnchors(PageLayout &page, const std::vector<Table> &tables);
+
+  /**
+   * Remove the anchors from rendered page text, setting each table's
+   * offset to where its anchor was (tables without one anchor at the end)
+   */
+  static void takeAnchors(std::string &text, std::vector<Table> &tables);
+
+  /**
+   * Serialize rows of cells; the first row is the Markdown header
+   */
+  static std::string
+  serialize(const std::vector<std::vector<std::string>> &rows,
+            TableFormat format);
+
+  const TableOptions &getOptions() const { return options_; }
+
+private:
+  TableOptions options_;
+};
+
+} // namespace guardian
+
+#endif // TABLE_DETECTOR_H
@@ -0,0 +1,263 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include "ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace guardian {
+
+template <typename T = void> class Task;
+
+namespace detail {
+
+// Result slot of a coroutine: a value (or nothing) or an exception
+template <typename T> struct Result {
+  std::optional<T> value;
+  std::exception_ptr error;
+
+  template <typename U> void return_value(U &&result) {
+    value.emplace(std::forward<U>(result));
+  }
+  T take() {
+    if (error)
+      std::rethrow_exception(error);
+    return std::move(*value);
+  }
+};
+
+template <> struct Result<void> {
+  std::exception_ptr error;
+
+  void return_void() {}
+  void take() {
+    if (error)
+      std::rethrow_exception(error);
+  }
+};
+
+// Coroutine that starts at once and frees itself when it finishes
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+} // namespace detail
+
+/**
+ * Task - Lazily started coroutine producing a T
+ *
+ * A Task runs when it is awaited, on the awaiting thread, until its first
+ * suspension; when it finishes, the awaiting coroutine continues on
+ * whichever thread finished it (symmetric transfer, so long chains of
+ * awaits do not grow the stack). Exceptions propagate to the awaiter.
+ * Per-document work is written as straight-line code that suspends on
+ * file reads (IoService) and moves to the pool with schedule():
+ *
+ *   Task<Pages> extract(std::string path) {
+ *     std::vector<char> data = co_await IoService::instance().read(path);
+ *     co_await schedule();
+ *     ...
+ *   }
+ *
+ * A Task is move-only and owns its coroutine frame.
+ */
+template <typename T> class [[nodiscard]] Task {
+public:
+  struct promise_type : detail::Result<T> {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+        return handle.promise().continuation;
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { this->error = std::current_exception(); }
+  };
+
+  Task(Task &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (handle_)
+        handle_.destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  ~Task() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() { return handle.promise().take(); }
+    };
+    return Awaiter{handle_};
+  }
+
+private:
+  explicit Task(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * Continue the awaiting coroutine on a worker of the pool
+ */
+inline auto schedule(ThreadPool &pool = ThreadPool::instance()) {
+  struct Awaiter {
+    ThreadPool &pool;
+
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      pool.post([handle]() { handle.resume(); });
+    }
+    void await_resume() noexcept {}
+  };
+  return Awaiter{pool};
+}
+
+namespace detail {
+
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <typename T> struct SyncState {
+  std::mutex mutex;
+  std::condition_variable done;
+  bool finished = false;
+  Result<Stored<T>> result;
+};
+
+template <typename T> Detached syncDrive(Task<T> task, SyncState<T> *state) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      state->result.value.emplace();
+    } else {
+      state->result.value.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    state->result.error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->finished = true;
+  state->done.notify_one();
+}
+
+template <typename T> struct AllState {
+  std::atomic<size_t> remaining;
+  std::coroutine_handle<> waiter;
+  std::vector<Result<Stored<T>>> results;
+};
+
+template <typename T>
+Detached allDrive(Task<T> task, AllState<T> *state, size_t index) {
+  Result<Stored<T>> &result = state->results[index];
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      result.value.emplace();
+    } else {
+      result.value.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    result.error = std::current_exception();
+  }
+  if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    state->waiter.resume(); // Last one in
+}
+
+} // namespace detail
+
+/**
+ * Block the calling thread until a task finishes; for entry points only
+ * (never from a coroutine or a pool task)
+ */
+template <typename T> T syncWait(Task<T> task) {
+  detail::SyncState<T> state;
+  detail::syncDrive(std::move(task), &state);
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.done.wait(lock, [&state] { return state.finished; });
+  if constexpr (std::is_void_v<T>) {
+    state.result.take();
+  } else {
+    return state.result.take();
+  }
+}
+
+/**
+ * Await all tasks; they are started in order and run concurrently from
+ * their first suspension. The first exception (by index) is rethrown
+ * once every task has finished.
+ */
+template <typename T>
+Task<std::vector<detail::Stored<T>>> whenAll(std::vector<Task<T>> tasks) {
+  detail::AllState<T> state;
+  state.results.resize(tasks.size());
+  state.remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+
+  struct Awaiter {
+    std::vector<Task<T>> &tasks;
+    detail::AllState<T> &state;
+
+    bool await_ready() noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      state.waiter = handle;
+      for (size_t i = 0; i < tasks.size(); ++i)
+        detail::allDrive(std::move(tasks[i]), &state, i);
+      // Resume at once if every task already finished
+      return state.remaining.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+    void await_resume() noexcept {}
+  };
+  co_await Awaiter{tasks, state};
+
+  std::vector<detail::Stored<T>> values;
+  values.reserve(state.results.size());
+  for (auto &result : state.results)
+    values.push_back(result.take());
+  co_return values;
+}
+
+} // namespace guardian
+
+#endif // TASK_H
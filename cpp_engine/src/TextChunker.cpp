@@ -1,44 +1,126 @@
 #include "TextChunker.h"
+#include "ThreadPool.h"
+#include "Tokenizer.h"
 #include <algorithm>
-#include <sstream>
+#include <cctype>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 
 namespace guardian {
 
-TextChunker::TextChunker(int chunkSize, int overlapSize)
-    : chunkSize_(chunkSize), overlapSize_(overlapSize) {
-  if (overlapSize >= chunkSize) {
-    throw std::invalid_argument("Overlap size must be less than chunk size");
+namespace {
+
+// Below this many bytes per task, scheduling costs more than chunking
+// serially
+constexpr size_t MIN_BYTES_PER_TASK = 32 * 1024;
+
+// Split texts into contiguous runs of roughly equal bytes; run w is
+// [bounds[w], bounds[w + 1])
+std::vector<size_t> partition(const std::vector<std::string> &texts,
+                              size_t bytes, size_t runs) {
+  std::vector<size_t> bounds(1, 0);
+  size_t seen = 0;
+  for (size_t i = 0; i < texts.size() && bounds.size() < runs; ++i) {
+    seen += texts[i].size();
+    if (seen * runs >= bytes * bounds.size())
+      bounds.push_back(i + 1);
+  }
+  if (bounds.back() < texts.size())
+    bounds.push_back(texts.size());
+  return bounds;
+}
+
+std::string joinRange(const ChunkHierarchy &h,
+                      const std::vector<uint32_t> &ranges, size_t i) {
+  if (i >= ranges.size() / 2) {
+    throw std::out_of_range("Chunk index out of range");
+  }
+  return Tokenizer::join(h.text, h.words, ranges[2 * i], ranges[2 * i + 1]);
+}
+
+} // namespace
+
+std::string_view ChunkSpans::view(size_t i) const {
+  if (i >= size()) {
+    throw std::out_of_range("Chunk index out of range");
   }
+  return std::string_view(text).substr(bounds[2 * i],
+                                       bounds[2 * i + 1] - bounds[2 * i]);
 }
 
-std::vector<std::string> TextChunker::splitIntoWords(const std::string &text) {
-  std::vector<std::string> words;
-  std::istringstream stream(text);
-  std::string word;
+std::string ChunkSpans::chunk(size_t i) const {
+  std::string_view bytes = view(i);
+  std::vector<Tokenizer::Span> spans;
+  Tokenizer::split(bytes.data(), bytes.size(), spans);
 
-  while (stream >> word) {
-    words.push_back(word);
+  std::string result;
+  result.reserve(bytes.size());
+  for (size_t w = 0; w < spans.size(); ++w) {
+    if (w > 0 && spans[w].first > spans[w - 1].second)
+      result += ' ';
+    result.append(bytes.data() + spans[w].first,
+                  spans[w].second - spans[w].first);
   }
+  return result;
+}
 
-  return words;
+std::vector<std::string> ChunkSpans::materialize() const {
+  std::vector<std::string> chunks;
+  chunks.reserve(size());
+  for (size_t i = 0; i < size(); ++i)
+    chunks.push_back(chunk(i));
+  return chunks;
 }
 
-std::string TextChunker::joinWords(const std::vector<std::string> &words,
-                                   int start, int end) {
-  if (start >= end || start >= static_cast<int>(words.size())) {
-    return "";
+size_t ChunkSpans::memoryBytes() const {
+  return text.capacity() + bounds.capacity() * sizeof(uint32_t);
+}
+
+std::string ChunkHierarchy::parent(size_t i) const {
+  return joinRange(*this, parents, i);
+}
+
+std::string ChunkHierarchy::child(size_t i) const {
+  return joinRange(*this, children, i);
+}
+
+TextChunker::TextChunker(int chunkSize, int overlapSize)
+    : chunkSize_(chunkSize), overlapSize_(overlapSize) {
+  validate(chunkSize, overlapSize);
+}
+
+void TextChunker::validate(int chunkSize, int overlapSize) {
+  if (chunkSize < 1) {
+    throw std::invalid_argument("Chunk size must be positive");
   }
+  if (overlapSize < 0) {
+    throw std::invalid_argument("Overlap size must not be negative");
+  }
+  if (overlapSize >= chunkSize) {
+    throw std::invalid_argument("Overlap size must be less than chunk size");
+  }
+}
 
-  end = std::min(end, static_cast<int>(words.size()));
+std::vector<std::pair<int, int>>
+TextChunker::chunkWindows(int wordCount) const {
+  std::vector<std::pair<int, int>> windows;
+  int stride = chunkSize_ - overlapSize_;
+  int currentPos = 0;
+
+  while (currentPos < wordCount) {
+    windows.emplace_back(currentPos,
+                         std::min(currentPos + chunkSize_, wordCount));
+
+    currentPos += stride;
 
-  std::ostringstream result;
-  for (int i = start; i < end; ++i) {
-    if (i > start)
-      result << " ";
-    result << words[i];
+    // If remaining words are less than overlap, include them in the last chunk
+    if (currentPos < wordCount && currentPos + overlapSize_ >= wordCount) {
+      break;
+    }
   }
 
-  return result.str();
+  return windows;
 }
 
 std::vector<std::string> TextChunker::chunk(const std::string &text) {
@@ -48,30 +130,19 @@ std::vector<std::string> TextChunker::chunk(const std::string &text) {
     return chunks;
   }
 
-  std::vector<std::string> words = splitIntoWords(text);
+  std::vector<Tokenizer::Span> words = Tokenizer::split(text);
 
   if (words.empty()) {
     return chunks;
   }
 
-  int stride = chunkSize_ - overlapSize_;
-  int currentPos = 0;
-
-  while (currentPos < static_cast<int>(words.size())) {
-    int endPos = currentPos + chunkSize_;
-    std::string chunkText = joinWords(words, currentPos, endPos);
+  int wordCount = static_cast<int>(words.size());
+  for (const auto &[start, end] : chunkWindows(wordCount)) {
+    std::string chunkText = Tokenizer::join(text, words, start, end);
 
     if (!chunkText.empty()) {
       chunks.push_back(chunkText);
     }
-
-    currentPos += stride;
-
-    // If remaining words are less than overlap, include them in the last chunk
-    if (currentPos < static_cast<int>(words.size()) &&
-        currentPos + overlapSize_ >= static_cast<int>(words.size())) {
-      break;
-    }
   }
 
   return chunks;
@@ -79,14 +150,324 @@ std::vector<std::string> TextChunker::chunk(const std::string &text) {
 
 std::vector<std::string>
 TextChunker::chunkMultiple(const std::vector<std::string> &texts) {
-  std::vector<std::string> allChunks;
+  size_t bytes = 0;
+  for (const auto &text : texts)
+    bytes += text.size();
+  ThreadPool &pool = ThreadPool::instance();
+  size_t workers = threads_ ? threads_ : pool.size();
+  workers = std::min({workers, texts.size(), bytes / MIN_BYTES_PER_TASK});
 
-  for (const auto &text : texts) {
-    auto chunks = chunk(text);
-    allChunks.insert(allChunks.end(), chunks.begin(), chunks.end());
+  if (workers <= 1) {
+    std::vector<std::string> allChunks;
+    for (const auto &text : texts) {
+      auto chunks = chunk(text);
+      std::move(chunks.begin(), chunks.end(), std::back_inserter(allChunks));
+    }
+    return allChunks;
   }
 
+  // Each task chunks a contiguous run of texts into its own buffer
+  std::vector<size_t> bounds = partition(texts, bytes, workers);
+  const size_t runs = bounds.size() - 1;
+  std::vector<std::vector<std::string>> local(runs);
+  auto work = [&](size_t w) {
+    for (size_t i = bounds[w]; i < bounds[w + 1]; ++i) {
+      auto chunks = chunk(texts[i]);
+      std::move(chunks.begin(), chunks.end(), std::back_inserter(local[w]));
+    }
+  };
+
+  TaskGroup group(pool);
+  for (size_t w = 1; w < runs; ++w)
+    group.run([&work, w]() { work(w); });
+  work(0);
+  group.wait();
+
+  // Runs are in text order, so their offsets are a prefix sum of sizes
+  std::vector<size_t> offsets(runs + 1, 0);
+  for (size_t w = 0; w < runs; ++w)
+    offsets[w + 1] = offsets[w] + local[w].size();
+
+  std::vector<std::string> allChunks(offsets.back());
+  for (size_t w = 0; w < runs; ++w) {
+    std::move(local[w].begin(), local[w].end(),
+              allChunks.begin() + offsets[w]);
+  }
   return allChunks;
 }
 
+ScannedChunks TextChunker::chunkAndScan(const std::string &text,
+                                        const ContentScanner &scanner,
+                                        bool redact) {
+  ScannedChunks result;
+  std::vector<Tokenizer::Span> spans = Tokenizer::split(text);
+
+  if (spans.empty()) {
+    return result;
+  }
+
+  std::vector<Finding> findings = scanner.scan(text);
+  std::string redactedText;
+  if (redact) {
+    // Masking preserves word boundaries, so the same spans apply
+    redactedText = ContentScanner::redact(text, findings);
+  }
+
+  int wordCount = static_cast<int>(spans.size());
+  size_t firstFinding = 0; // Findings before it end before this chunk
+  // Windows are never empty: the constructor rejects sizes below 1
+  for (const auto &[start, end] : chunkWindows(wordCount)) {
+    int chunkIndex = static_cast<int>(result.chunks.size());
+    size_t chunkBegin = spans[start].first;
+    size_t chunkEnd = spans[end - 1].second;
+
+    result.chunks.push_back(Tokenizer::join(text, spans, start, end));
+    if (redact) {
+      result.redacted.push_back(
+          Tokenizer::join(redactedText, spans, start, end));
+    }
+
+    // Findings are sorted by offset and chunks advance through the text,
+    // so findings ending before this chunk are done with for good
+    while (firstFinding < findings.size() &&
+           findings[firstFinding].offset + findings[firstFinding].length <=
+               chunkBegin)
+      ++firstFinding;
+
+    // Attach every finding overlapping the chunk
+    std::vector<Finding> chunkFindings;
+    for (size_t i = firstFinding; i < findings.size(); ++i) {
+      const Finding &f = findings[i];
+      if (f.offset >= chunkEnd)
+        break;
+      if (f.offset + f.length > chunkBegin) {
+        chunkFindings.push_back(f);
+        chunkFindings.back().chunkIndex = chunkIndex;
+      }
+    }
+    result.findings.push_back(std::move(chunkFindings));
+  }
+
+  return result;
+}
+
+ScannedChunks
+TextChunker::chunkMultipleAndScan(const std::vector<std::string> &texts,
+                                  const ContentScanner &scanner, bool redact) {
+  ScannedChunks all;
+
+  for (const auto &text : texts) {
+    ScannedChunks page = chunkAndScan(text, scanner, redact);
+    int base = static_cast<int>(all.chunks.size());
+
+    for (auto &chunkFindings : page.findings) {
+      for (auto &f : chunkFindings)
+        f.chunkIndex += base;
+    }
+
+    std::move(page.chunks.begin(), page.chunks.end(),
+              std::back_inserter(all.chunks));
+    std::move(page.findings.begin(), page.findings.end(),
+              std::back_inserter(all.findings));
+    std::move(page.redacted.begin(), page.redacted.end(),
+              std::back_inserter(all.redacted));
+  }
+
+  return all;
+}
+
+std::vector<SectionChunk>
+TextChunker::chunkSections(const std::vector<std::string> &pages,
+                           const std::vector<Heading> &headings,
+                           const std::vector<Table> &tables) {
+  std::vector<SectionChunk> result;
+  std::vector<SectionChunk> pendingTables; // Emitted after their section
+  std::vector<std::string> path;
+  std::vector<int> levels;
+
+  // Text of the current section, with the buffer offset where each page's
+  // share of it begins
+  std::string section;
+  std::vector<std::pair<size_t, int>> pageStarts;
+  size_t bodyFrom = 0; // Text before this offset is heading titles only
+
+  auto hasBody = [&]() {
+    for (size_t i = bodyFrom; i < section.size(); ++i) {
+      if (!std::isspace(static_cast<unsigned char>(section[i])))
+        return true;
+    }
+    return false;
+  };
+
+  auto flush = [&]() {
+    std::vector<Tokenizer::Span> spans = Tokenizer::split(section);
+    int wordCount = static_cast<int>(spans.size());
+    for (const auto &[start, end] : chunkWindows(wordCount)) {
+      auto page = std::upper_bound(
+          pageStarts.begin(), pageStarts.end(),
+          std::make_pair(spans[start].first, std::numeric_limits<int>::max()));
+      result.push_back({Tokenizer::join(section, spans, start, end), path,
+                        std::prev(page)->second});
+    }
+    std::move(pendingTables.begin(), pendingTables.end(),
+              std::back_inserter(result));
+    pendingTables.clear();
+    section.clear();
+    pageStarts.clear();
+    bodyFrom = 0;
+  };
+
+  auto append = [&](int page, const std::string &text, size_t from,
+                    size_t to) {
+    if (pageStarts.empty() || pageStarts.back().second != page) {
+      if (!section.empty())
+        section += '\n';
+      pageStarts.emplace_back(section.size(), page);
+    }
+    section.append(text, from, to - from);
+  };
+
+  size_t h = 0, t = 0;
+  for (int p = 0; p < static_cast<int>(pages.size()); ++p) {
+    const std::string &text = pages[p];
+    size_t pos = 0;
+
+    while (true) {
+      bool headingNext = h < headings.size() && headings[h].page <= p;
+      bool tableNext = t < tables.size() && tables[t].page <= p;
+      if (!headingNext && !tableNext) {
+        break;
+      }
+
+      // Tables come first at equal positions: they precede the heading
+      // line that their anchor was rendered before
+      if (tableNext &&
+          (!headingNext || tables[t].page < headings[h].page ||
+           (tables[t].page == headings[h].page &&
+            tables[t].offset <= headings[h].offset))) {
+        const Table &table = tables[t++];
+        if (table.page == p) {
+          pendingTables.push_back({table.text, path, p, true});
+        }
+        continue;
+      }
+
+      const Heading &heading = headings[h++];
+      if (heading.page < p || heading.offset < pos ||
+          heading.offset > text.size()) {
+        continue; // Out of order or stale offset
+      }
+
+      append(p, text, pos, heading.offset);
+      pos = heading.offset;
+      // A heading with nothing under it stays with the next section
+      if (hasBody()) {
+        flush();
+      }
+
+      while (!levels.empty() && levels.back() >= heading.level) {
+        levels.pop_back();
+        path.pop_back();
+      }
+      levels.push_back(heading.level);
+      path.push_back(heading.title);
+
+      append(p, text, pos, std::min(text.size(), pos + heading.title.size()));
+      pos = std::min(text.size(), pos + heading.title.size());
+      bodyFrom = section.size();
+    }
+
+    append(p, text, pos, text.size());
+  }
+  flush();
+
+  return result;
+}
+
+ChunkHierarchy
+TextChunker::chunkHierarchy(const std::vector<std::string> &texts,
+                            int parentSize) const {
+  // With chunkSize_ >= 1 this also keeps the parent loop advancing
+  if (parentSize < chunkSize_) {
+    throw std::invalid_argument("Parent size must be at least chunk size");
+  }
+
+  ChunkHierarchy result;
+  size_t bytes = texts.size();
+  for (const auto &text : texts)
+    bytes += text.size();
+  result.text.reserve(bytes);
+
+  for (const auto &text : texts) {
+    if (!result.text.empty())
+      result.text += '\n';
+    size_t base = result.text.size();
+    size_t first = result.words.size();
+    result.text += text;
+    Tokenizer::split(text.data(), text.size(), result.words);
+    for (size_t i = first; i < result.words.size(); ++i) {
+      result.words[i].first += base;
+      result.words[i].second += base;
+    }
+
+    // Parents tile the text's words; children window each parent
+    const size_t last = result.words.size();
+    for (size_t start = first; start < last; start += parentSize) {
+      size_t end = std::min(start + parentSize, last);
+      auto parentIndex = static_cast<uint32_t>(result.parentCount());
+      result.parents.push_back(static_cast<uint32_t>(start));
+      result.parents.push_back(static_cast<uint32_t>(end));
+
+      for (const auto &[from, to] :
+           chunkWindows(static_cast<int>(end - start))) {
+        result.children.push_back(static_cast<uint32_t>(start + from));
+        result.children.push_back(static_cast<uint32_t>(start + to));
+        result.parentOf.push_back(parentIndex);
+      }
+    }
+  }
+
+  return result;
+}
+
+ChunkHierarchy TextChunker::chunkHierarchy(const std::string &text,
+                                           int parentSize) const {
+  return chunkHierarchy(std::vector<std::string>{text}, parentSize);
+}
+
+ChunkSpans
+TextChunker::chunkSpans(const std::vector<std::string> &texts) const {
+  ChunkSpans result;
+  size_t bytes = texts.size();
+  for (const auto &text : texts)
+    bytes += text.size();
+  if (bytes > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Texts too large for chunk spans");
+  }
+  result.text.reserve(bytes);
+
+  std::vector<Tokenizer::Span> words;
+  for (const auto &text : texts) {
+    if (!result.text.empty())
+      result.text += '\n';
+    const size_t base = result.text.size();
+    result.text += text;
+
+    words.clear();
+    Tokenizer::split(text.data(), text.size(), words);
+    for (const auto &[start, end] :
+         chunkWindows(static_cast<int>(words.size()))) {
+      result.bounds.push_back(static_cast<uint32_t>(base + words[start].first));
+      result.bounds.push_back(
+          static_cast<uint32_t>(base + words[end - 1].second));
+    }
+  }
+
+  return result;
+}
+
+ChunkSpans TextChunker::chunkSpans(const std::string &text) const {
+  return chunkSpans(std::vector<std::string>{text});
+}
+
 } // namespace guardian
@@ -1,16 +1,97 @@
 #ifndef TEXT_CHUNKER_H
 #define TEXT_CHUNKER_H
 
+#include "ContentScanner.h"
+#include "SectionDetector.h"
+#include "Tokenizer.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace guardian {
 
+/**
+ * ScannedChunks - Chunks together with their sensitive-content findings
+ */
+struct ScannedChunks {
+  std::vector<std::string> chunks;
+  std::vector<std::vector<Finding>> findings; // One list per chunk
+  std::vector<std::string> redacted;          // Empty unless requested
+};
+
+/**
+ * SectionChunk - A chunk with the headings of the section it belongs to
+ */
+struct SectionChunk {
+  std::string text;
+  std::vector<std::string> path; // Heading titles, outermost first
+  int page;                      // Page where the chunk starts
+  bool isTable = false;          // A whole serialized table
+};
+
+/**
+ * ChunkSpans - Chunks as byte ranges of one document buffer
+ *
+ * Overlapping chunks share the bytes of the buffer, so overlap costs no
+ * memory; chunk text is built only when asked for.
+ */
+struct ChunkSpans {
+  std::string text;             // Input texts, joined by '\n'
+  std::vector<uint32_t> bounds; // 2 per chunk: [begin, end) in text
+
+  size_t size() const { return bounds.size() / 2; }
+
+  /**
+   * Raw bytes of a chunk, with the source's whitespace
+   * @throws std::out_of_range for an invalid index
+   */
+  std::string_view view(size_t i) const;
+
+  /**
+   * Chunk text, identical to the corresponding TextChunker::chunk output
+   * @throws std::out_of_range for an invalid index
+   */
+  std::string chunk(size_t i) const;
+
+  std::vector<std::string> materialize() const;
+
+  size_t memoryBytes() const;
+};
+
+/**
+ * ChunkHierarchy - Child chunks nested in parent chunks over one text
+ *
+ * Both levels are word ranges into the same tokenized arena, stored flat
+ * as [start, end) pairs; text is only built when a chunk is requested.
+ * Parents tile the text without overlap and children overlap within
+ * their parent, so every child lies inside exactly one parent.
+ */
+struct ChunkHierarchy {
+  std::string text;                  // Input texts, joined by '\n'
+  std::vector<Tokenizer::Span> words; // Token byte spans in text
+  std::vector<uint32_t> parents;     // 2 per parent: word range
+  std::vector<uint32_t> children;    // 2 per child: word range
+  std::vector<uint32_t> parentOf;    // Child index -> parent index
+
+  size_t parentCount() const { return parents.size() / 2; }
+  size_t childCount() const { return parentOf.size(); }
+
+  /**
+   * Chunk text, joined as TextChunker::chunk joins it
+   * @throws std::out_of_range for an invalid index
+   */
+  std::string parent(size_t i) const;
+  std::string child(size_t i) const;
+};
+
 /**
  * TextChunker - Intelligent text segmentation
  *
  * Splits text into fixed-size chunks with overlap, preserving
- * sentence boundaries to maintain semantic coherence.
+ * sentence boundaries to maintain semantic coherence. Words are counted
+ * by Tokenizer, so CJK and Thai text is sized per character or cluster.
  */
 class TextChunker {
 public:
@@ -18,9 +99,16 @@ public:
    * Constructor
    * @param chunkSize Target number of words per chunk (default: 500)
    * @param overlapSize Number of overlapping words between chunks (default: 50)
+   * @throws std::invalid_argument unless 0 <= overlapSize < chunkSize
    */
   explicit TextChunker(int chunkSize = 500, int overlapSize = 50);
 
+  /**
+   * Check chunk sizes without building a chunker
+   * @throws std::invalid_argument unless 0 <= overlapSize < chunkSize
+   */
+  static void validate(int chunkSize, int overlapSize);
+
   /**
    * Chunk a single text block
    * @param text Input text to be chunked
@@ -29,19 +117,84 @@ public:
   std::vector<std::string> chunk(const std::string &text);
 
   /**
-   * Chunk multiple text blocks (e.g., PDF pages)
+   * Chunk multiple text blocks (e.g., PDF pages). Large inputs are split
+   * into contiguous runs of texts chunked as tasks on the shared
+   * ThreadPool; the result is the same as chunking the texts one after
+   * another.
    * @param texts Vector of input texts
    * @return Vector of all chunks from all texts
    */
   std::vector<std::string> chunkMultiple(const std::vector<std::string> &texts);
 
+  /**
+   * Tasks used by chunkMultiple: 0 = one per ThreadPool worker (default),
+   * 1 = always serial
+   */
+  void setThreadCount(unsigned threads) { threads_ = threads; }
+
+  /**
+   * Chunk a text block and scan it for PII/secrets in the same call. The
+   * text is tokenized once and scanned by ContentScanner::scan (its own
+   * linear passes); findings are then attached to chunks in one walk.
+   * @param text Input text to be chunked
+   * @param scanner Compiled rule set
+   * @param redact Also return chunks with findings masked
+   * @return Chunks with per-chunk findings (offsets into text)
+   */
+  ScannedChunks chunkAndScan(const std::string &text,
+                             const ContentScanner &scanner,
+                             bool redact = false);
+
+  /**
+   * Chunk and scan multiple text blocks (e.g., PDF pages)
+   */
+  ScannedChunks chunkMultipleAndScan(const std::vector<std::string> &texts,
+                                     const ContentScanner &scanner,
+                                     bool redact = false);
+
+  /**
+   * Chunk pages section by section: chunks never straddle a heading, and
+   * each carries its section path. A heading with no text before the next
+   * one (e.g. a chapter title directly followed by its first subsection)
+   * is kept with the following section. Each table becomes one chunk,
+   * whatever its size, emitted after the chunks of its section.
+   * @param pages Page texts
+   * @param headings Headings with offsets into pages, in document order
+   * @param tables Tables anchored in pages, in document order
+   */
+  std::vector<SectionChunk>
+  chunkSections(const std::vector<std::string> &pages,
+                const std::vector<Heading> &headings,
+                const std::vector<Table> &tables = {});
+
+  /**
+   * Chunk texts at two levels in one tokenization pass: parents of
+   * parentSize words, each split into children of the configured chunk
+   * size and overlap. Neither level crosses a text boundary.
+   * @param texts Input texts (e.g. PDF pages)
+   * @param parentSize Words per parent; at least the chunk size
+   * @throws std::invalid_argument if parentSize is below the chunk size
+   */
+  ChunkHierarchy chunkHierarchy(const std::vector<std::string> &texts,
+                                int parentSize) const;
+
+  ChunkHierarchy chunkHierarchy(const std::string &text, int parentSize) const;
+
+  /**
+   * Chunk texts into spans of one buffer instead of strings. Chunks never
+   * cross a text boundary; materialize() equals chunkMultiple(texts).
+   * @throws std::length_error if the texts exceed 4 GiB
+   */
+  ChunkSpans chunkSpans(const std::vector<std::string> &texts) const;
+
+  ChunkSpans chunkSpans(const std::string &text) const;
+
 private:
   int chunkSize_;
   int overlapSize_;
+  unsigned threads_ = 0;
 
-  std::vector<std::string> splitIntoWords(const std::string &text);
-  std::string joinWords(const std::vector<std::string> &words, int start,
-                        int end);
+  std::vector<std::pair<int, int>> chunkWindows(int wordCount) const;
 };
 
 } // namespace guardian
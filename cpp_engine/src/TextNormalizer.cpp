@@ -0,0 +1,424 @@
+#include "TextNormalizer.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace guardian {
+
+namespace {
+
+enum ByteClass : uint8_t {
+  Keep,    // Printable ASCII
+  Space,   // Horizontal whitespace
+  Newline, // Line break
+  Return,  // CR (folded into a following LF)
+  Drop,    // Control character
+  Multi    // Lead or stray continuation byte of a UTF-8 sequence
+};
+
+constexpr ByteClass classify(unsigned c) {
+  return c >= 0x80                              ? Multi
+         : c == ' ' || c == '\t' || c == '\v'   ? Space
+         : c == '\n' || c == '\f'               ? Newline
+         : c == '\r'                            ? Return
+         : c < 0x20 || c == 0x7F                ? Drop
+                                                : Keep;
+}
+
+struct ByteTable {
+  ByteClass cls[256];
+  constexpr ByteTable() : cls() {
+    for (unsigned c = 0; c < 256; ++c)
+      cls[c] = classify(c);
+  }
+};
+
+constexpr ByteTable BYTES;
+
+// Sequence length by lead byte (0 = invalid lead)
+struct LengthTable {
+  uint8_t len[256];
+  constexpr LengthTable() : len() {
+    for (unsigned c = 0; c < 256; ++c)
+      len[c] = c < 0x80 ? 1 : c < 0xC2 ? 0 : c < 0xE0 ? 2 : c < 0xF0 ? 3
+               : c < 0xF5 ? 4 : 0;
+  }
+};
+
+constexpr LengthTable LENGTHS;
+
+enum class Action : uint8_t { AsSpace, AsNewline, Remove, Replace, Fullwidth };
+
+struct Mapping {
+  uint32_t first;
+  uint32_t last;
+  Action action;
+  const char *replacement; // For Action::Replace
+};
+
+// Sorted, non-overlapping. Replacements never exceed the UTF-8 length of
+// the code points they replace, which is what makes the pass in-place.
+constexpr Mapping MAPPINGS[] = {
+    {0x0080, 0x009F, Action::Remove, nullptr},    // C1 controls
+    {0x00A0, 0x00A0, Action::AsSpace, nullptr},   // NBSP
+    {0x00AD, 0x00AD, Action::Remove, nullptr},    // Soft hyphen
+    {0x2000, 0x200A, Action::AsSpace, nullptr},   // En quad .. hair space
+    {0x200B, 0x200F, Action::Remove, nullptr},   // ZWSP, ZWNJ, ZWJ, LRM, RLM
+    {0x2010, 0x2011, Action::Replace, "-"},       // Hyphen, NB hyphen
+    {0x2024, 0x2024, Action::Replace, "."},       // One dot leader
+    {0x2025, 0x2025, Action::Replace, ".."},      // Two dot leader
+    {0x2026, 0x2026, Action::Replace, "..."},     // Ellipsis
+    {0x2028, 0x2029, Action::AsNewline, nullptr}, // Line/paragraph separator
+    {0x202A, 0x202E, Action::Remove, nullptr},    // Bidi embeddings
+    {0x202F, 0x202F, Action::AsSpace, nullptr},   // Narrow NBSP
+    {0x205F, 0x205F, Action::AsSpace, nullptr},   // Medium math space
+    {0x2060, 0x2064, Action::Remove, nullptr},    // Word joiner, invisibles
+    {0x3000, 0x3000, Action::AsSpace, nullptr},   // Ideographic space
+    {0xFB00, 0xFB00, Action::Replace, "ff"},
+    {0xFB01, 0xFB01, Action::Replace, "fi"},
+    {0xFB02, 0xFB02, Action::Replace, "fl"},
+    {0xFB03, 0xFB03, Action::Replace, "ffi"},
+    {0xFB04, 0xFB04, Action::Replace, "ffl"},
+    {0xFB05, 0xFB06, Action::Replace, "st"},
+    {0xFEFF, 0xFEFF, Action::Remove, nullptr},    // BOM / ZWNBSP
+    {0xFF01, 0xFF5E, Action::Fullwidth, nullptr}, // Fullwidth ASCII
+};
+
+const Mapping *findMapping(uint32_t cp) {
+  // Most non-ASCII text (Latin-1 letters, Greek, Cyrillic, ...) lives in
+  // the gap and never needs the search.
+  if ((cp > 0x00AD && cp < 0x2000) || cp > 0xFF5E) {
+    return nullptr;
+  }
+  const Mapping *end = MAPPINGS + sizeof(MAPPINGS) / sizeof(MAPPINGS[0]);
+  const Mapping *it = std::upper_bound(
+      MAPPINGS, end, cp,
+      [](uint32_t value, const Mapping &m) { return value < m.first; });
+  if (it == MAPPINGS || cp > (it - 1)->last) {
+    return nullptr;
+  }
+  return it - 1;
+}
+
+// Decode one UTF-8 sequence; returns its length or 0 if malformed.
+size_t decode(const unsigned char *p, size_t avail, uint32_t &cp) {
+  size_t len = LENGTHS.len[p[0]];
+  if (len == 0 || len > avail) {
+    return 0;
+  }
+  cp = p[0] & (0x7F >> len);
+  for (size_t i = 1; i < len; ++i) {
+    if ((p[i] & 0xC0) != 0x80) {
+      return 0;
+    }
+    cp = (cp << 6) | (p[i] & 0x3F);
+  }
+  // Reject overlongs and surrogates
+  if ((len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) ||
+      (len == 4 && (cp < 0x10000 || cp > 0x10FFFF))) {
+    return 0;
+  }
+  return len;
+}
+
+// FNV-1a over ASCII-lower-cased bytes, split into two Bloom hashes
+uint64_t foldedHash(const char *s, size_t n) {
+  uint64_t h = 1469598103934665603ULL;
+  for (size_t i = 0; i < n; ++i) {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    if (c >= 'A' && c <= 'Z')
+      c += 32;
+    h = (h ^ c) * 1099511628211ULL;
+  }
+  return h;
+}
+
+constexpr int BLOOM_HASHES = 3;
+
+void bloomAdd(TextNormalizer::CompoundFilter &filter, const char *s,
+              size_t n) {
+  uint64_t h = foldedHash(s, n);
+  uint64_t h2 = (h >> 32) | 1;
+  for (int i = 0; i < BLOOM_HASHES; ++i) {
+    uint64_t bit = (h + i * h2) % (filter.size() * 64);
+    filter[bit / 64] |= uint64_t(1) << (bit % 64);
+  }
+}
+
+bool bloomContains(const TextNormalizer::CompoundFilter &filter,
+                   const char *s, size_t n) {
+  uint64_t h = foldedHash(s, n);
+  uint64_t h2 = (h >> 32) | 1;
+  for (int i = 0; i < BLOOM_HASHES; ++i) {
+    uint64_t bit = (h + i * h2) % (filter.size() * 64);
+    if (!(filter[bit / 64] >> (bit % 64) & 1))
+      return false;
+  }
+  return true;
+}
+
+// Words that are commonly the first half of a hyphenated compound and
+// rarely a syllable split by a line-break hyphen.
+const char *const COMPOUND_PREFIXES[] = {
+    "self",  "well",  "non",   "ex",     "half",   "ill",    "all",
+    "high",  "low",   "long",  "short",  "full",   "state",  "first",
+    "second", "third", "real", "open",   "end",    "user",   "time",
+    "anti",  "semi",  "quasi", "pseudo", "mid",    "vice",   "peer",
+    "twenty", "thirty", "forty", "fifty", "sixty", "seventy", "eighty",
+    "ninety", "one",  "two",   "three",  "four",   "five",   "data",
+    "large", "small", "built", "fine",   "old",    "new",    "year",
+    "day",   "run",   "read",  "write",  "front",  "back",   "top",
+    "left",  "right", "cost",  "risk",   "rule",   "case",   "word"};
+
+bool isAsciiLetter(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// Letters for hyphenation purposes; any non-ASCII byte counts, since
+// scripts with hyphenation are alphabetic.
+bool isLetterByte(unsigned char c) { return isAsciiLetter(c) || c >= 0x80; }
+
+class Writer {
+public:
+  Writer(char *out, const NormalizeOptions &options,
+         const TextNormalizer::CompoundFilter &compounds,
+         TextNormalizer::Stats &stats)
+      : out_(out), options_(options), compounds_(compounds), stats_(stats) {}
+
+  size_t size() const { return w_; }
+  char last() const { return pending_ || !w_ ? '\n' : out_[w_ - 1]; }
+
+  void put(char c) {
+    if (pending_)
+      resolve(static_cast<unsigned char>(c));
+    out_[w_++] = c;
+  }
+  void put(const char *s, size_t n) {
+    if (pending_)
+      resolve(static_cast<unsigned char>(s[0]));
+    std::memmove(out_ + w_, s, n);
+    w_ += n;
+  }
+
+  void space() {
+    char l = last();
+    if (l != ' ' && l != '\n')
+      out_[w_++] = ' ';
+  }
+
+  // Line breaks are held until the next visible byte decides their fate;
+  // one ends a line, two mark a paragraph break, more are dropped.
+  void newline() {
+    if (w_ && !pending_ && out_[w_ - 1] == ' ')
+      --w_;
+    if (w_ && pending_ < 2)
+      ++pending_;
+  }
+
+  void softHyphen() { softHyphenAt_ = w_; }
+
+  void trimEnd() {
+    pending_ = 0;
+    while (w_ && out_[w_ - 1] == ' ')
+      --w_;
+  }
+
+private:
+  char *out_;
+  const NormalizeOptions &options_;
+  const TextNormalizer::CompoundFilter &compounds_;
+  TextNormalizer::Stats &stats_;
+  size_t w_ = 0;
+  int pending_ = 0;
+  size_t lineStart_ = 0;
+  size_t longestLine_ = 0;
+  size_t softHyphenAt_ = static_cast<size_t>(-1);
+
+  // Every byte written here was consumed from a pending line break or a
+  // retracted hyphen, so the pass stays in place.
+  void resolve(unsigned char next) {
+    int count = pending_;
+    pending_ = 0;
+    size_t lineLength = w_ - lineStart_;
+    longestLine_ = std::max(longestLine_, lineLength);
+
+    if (count == 1 && options_.dehyphenate && joinHyphenated(next)) {
+      ++stats_.hyphensJoined;
+    } else if (count == 1 && options_.joinLines && !paragraphEnd(lineLength)) {
+      out_[w_++] = ' ';
+      ++stats_.linesJoined;
+    } else {
+      while (count--)
+        out_[w_++] = '\n';
+    }
+    lineStart_ = w_;
+  }
+
+  // A short line finishing a sentence is taken as the end of a paragraph
+  bool paragraphEnd(size_t lineLength) const {
+    char end = out_[w_ - 1];
+    bool sentenceEnd = end == '.' || end == '!' || end == '?' || end == ':';
+    return sentenceEnd && lineLength * 10 < longestLine_ * 6;
+  }
+
+  bool joinHyphenated(unsigned char next) {
+    if (softHyphenAt_ == w_ && isLetterByte(next)) {
+      return true;
+    }
+    if (w_ < 2 || out_[w_ - 1] != '-' ||
+        !isLetterByte(static_cast<unsigned char>(out_[w_ - 2])) ||
+        !(isLetterByte(next) || (next >= '0' && next <= '9'))) {
+      return false;
+    }
+
+    // The word before the hyphen: [begin, end)
+    size_t end = w_ - 1;
+    size_t begin = end;
+    while (begin > 0 &&
+           isLetterByte(static_cast<unsigned char>(out_[begin - 1])))
+      --begin;
+
+    bool upper = false;
+    for (size_t i = begin + 1; i < end; ++i)
+      upper |= out_[i] >= 'A' && out_[i] <= 'Z';
+    bool lowerNext = (next >= 'a' && next <= 'z') || next >= 0x80;
+
+    bool keep = end - begin == 1 || upper || !lowerNext ||
+                (begin > 0 && out_[begin - 1] == '-') ||
+                bloomContains(compounds_, out_ + begin, end - begin);
+    if (!keep) {
+      --w_;
+    }
+    return true;
+  }
+};
+
+#if defined(__SSE2__)
+// True if the 16 bytes are printable ASCII with no doubled spaces, i.e.
+// the block normalizes to itself.
+bool cleanBlock(const unsigned char *p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  __m128i printable =
+      _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)),
+                    _mm_cmplt_epi8(v, _mm_set1_epi8(0x7F)));
+  if (_mm_movemask_epi8(printable) != 0xFFFF) {
+    return false;
+  }
+  int spaces = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+  return (spaces & (spaces >> 1)) == 0;
+}
+#endif
+
+} // namespace
+
+TextNormalizer::TextNormalizer(const NormalizeOptions &options)
+    : options_(options), compounds_{} {
+  for (const char *prefix : COMPOUND_PREFIXES) {
+    bloomAdd(compounds_, prefix, std::strlen(prefix));
+  }
+  resetStats();
+}
+
+void TextNormalizer::addCompoundPrefix(const std::string &prefix) {
+  bloomAdd(compounds_, prefix.data(), prefix.size());
+}
+
+void TextNormalizer::resetStats() { stats_ = {0, 0, 0, 0, 0, 0}; }
+
+void TextNormalizer::normalize(std::string &text) {
+  const size_t n = text.size();
+  char *buf = text.empty() ? nullptr : &text[0];
+  const unsigned char *in = reinterpret_cast<const unsigned char *>(buf);
+  Writer out(buf, options_, compounds_, stats_);
+  size_t r = 0;
+  size_t scalarEnd = 0; // Don't retry the fast path inside a dirty block
+
+  stats_.bytesIn += n;
+
+  while (r < n) {
+#if defined(__SSE2__)
+    if (r >= scalarEnd && r + 16 <= n) {
+      if (cleanBlock(in + r) &&
+          (in[r] != ' ' || (out.last() != ' ' && out.last() != '\n'))) {
+        out.put(buf + r, 16);
+        r += 16;
+        continue;
+      }
+      scalarEnd = r + 16;
+    }
+#endif
+
+    unsigned char c = in[r];
+    switch (BYTES.cls[c]) {
+    case Keep:
+      out.put(static_cast<char>(c));
+      ++r;
+      continue;
+    case Space:
+      out.space();
+      ++r;
+      continue;
+    case Newline:
+      out.newline();
+      ++r;
+      continue;
+    case Return:
+      if (r + 1 >= n || in[r + 1] != '\n')
+        out.newline();
+      ++r;
+      continue;
+    case Drop:
+      ++stats_.charsRemoved;
+      ++r;
+      continue;
+    case Multi:
+      break;
+    }
+
+    uint32_t cp;
+    size_t len = decode(in + r, n - r, cp);
+    if (len == 0) {
+      out.put(static_cast<char>(c));
+      ++r;
+      continue;
+    }
+
+    const Mapping *m = findMapping(cp);
+    if (!m) {
+      out.put(buf + r, len);
+    } else {
+      switch (m->action) {
+      case Action::AsSpace:
+        out.space();
+        break;
+      case Action::AsNewline:
+        out.newline();
+        break;
+      case Action::Remove:
+        if (cp == 0x00AD)
+          out.softHyphen();
+        ++stats_.charsRemoved;
+        break;
+      case Action::Replace:
+        out.put(m->replacement, std::strlen(m->replacement));
+        ++stats_.charsMapped;
+        break;
+      case Action::Fullwidth:
+        out.put(static_cast<char>(cp - 0xFEE0));
+        ++stats_.charsMapped;
+        break;
+      }
+    }
+    r += len;
+  }
+
+  out.trimEnd();
+  text.resize(out.size());
+  stats_.bytesOut += out.size();
+}
+
+} // namespace guardian
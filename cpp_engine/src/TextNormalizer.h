@@ -0,0 +1,91 @@
+#ifndef TEXT_NORMALIZER_H
+#define TEXT_NORMALIZER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace guardian {
+
+/**
+ * NormalizeOptions - Optional line repair stages of TextNormalizer
+ */
+struct NormalizeOptions {
+  bool dehyphenate = true; // Rejoin words hyphenated across line breaks
+  bool joinLines = true;   // Merge hard-wrapped lines into paragraphs
+};
+
+/**
+ * TextNormalizer - In-place cleanup of extracted page text
+ *
+ * A single fused pass over a UTF-8 buffer that:
+ *  - applies the NFKC compatibility mappings that matter for PDF text
+ *    (ligatures U+FB00-FB06, fullwidth ASCII, NBSP and other fixed-width
+ *    spaces, two-dot/ellipsis leaders);
+ *  - removes soft hyphens, zero-width and bidi format characters, and C0/C1
+ *    control characters;
+ *  - collapses runs of horizontal whitespace to one space, trims spaces at
+ *    line ends, and keeps at most one blank line between paragraphs;
+ *  - optionally rejoins words hyphenated across a line break and merges
+ *    hard-wrapped lines. Line breaks are held pending until the next
+ *    visible byte, so both decisions are made in the same pass.
+ *
+ * A hyphen at a line break is kept ("well-known") when the word before it
+ * is a single letter, is upper-case, follows another hyphen, is followed by
+ * a capital or digit, or is a known compound prefix (a small Bloom filter,
+ * extendable with addCompoundPrefix). Otherwise it is removed
+ * ("inter-\nnational" -> "international"). A line is kept as a paragraph
+ * end when it finishes a sentence and is clearly shorter than the page's
+ * longest line; every other single line break becomes a space.
+ *
+ * Every mapping produces no more bytes than it consumes, so the output is
+ * written over the input. Runs of printable ASCII are copied 16 bytes at a
+ * time (SSE2); everything else goes through a table-driven UTF-8 path.
+ * Malformed UTF-8 bytes are passed through unchanged.
+ */
+class TextNormalizer {
+public:
+  explicit TextNormalizer(const NormalizeOptions &options = NormalizeOptions());
+
+  /**
+   * Register a word whose trailing hyphen is real at a line break
+   * (e.g. "self" keeps "self-\ncontained" hyphenated)
+   */
+  void addCompoundPrefix(const std::string &prefix);
+
+  /**
+   * Normalize text in place
+   * @param text UTF-8 buffer; shrunk to the normalized length
+   */
+  void normalize(std::string &text);
+
+  /**
+   * Statistics accumulated since construction or the last resetStats()
+   */
+  struct Stats {
+    size_t bytesIn;
+    size_t bytesOut;
+    size_t charsMapped;   // Compatibility mappings applied
+    size_t charsRemoved;  // Format/control characters dropped
+    size_t hyphensJoined; // Words rejoined across a line break
+    size_t linesJoined;   // Hard line breaks merged into a space
+  };
+
+  Stats getStats() const { return stats_; }
+  void resetStats();
+
+  const NormalizeOptions &getOptions() const { return options_; }
+
+  // Bloom filter over lower-cased compound prefixes (4096 bits, k = 3)
+  using CompoundFilter = std::array<uint64_t, 64>;
+
+private:
+  NormalizeOptions options_;
+  CompoundFilter compounds_;
+  Stats stats_;
+};
+
+} // namespace guardian
+
+#endif // TEXT_NORMALIZER_H
@@ -0,0 +1,298 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace guardian {
+
+namespace {
+
+constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+
+// Worker identity of the calling thread
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local size_t currentIndex = NO_WORKER;
+
+uint64_t nextRandom(uint64_t &state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// Spin, then yield, then sleep briefly while waiting for other threads
+class Backoff {
+public:
+  void pause() {
+    if (rounds_ < 64) {
+      ++rounds_;
+    } else if (rounds_ < 128) {
+      ++rounds_;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  void reset() { rounds_ = 0; }
+
+private:
+  int rounds_ = 0;
+};
+
+void pinToCpu(size_t index) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return;
+  }
+  int count = CPU_COUNT(&allowed);
+  if (count <= 0) {
+    return;
+  }
+  int target = static_cast<int>(index % static_cast<size_t>(count));
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+      cpu_set_t one;
+      CPU_ZERO(&one);
+      CPU_SET(cpu, &one);
+      pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+      return;
+    }
+  }
+#else
+  (void)index; // Pinning is best effort
+#endif
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(const ThreadPoolOptions &options) : options_(options) {
+  start();
+}
+
+ThreadPool::~ThreadPool() { stop(); }
+
+ThreadPool &ThreadPool::instance() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::configure(const ThreadPoolOptions &options) {
+  if (isWorker()) {
+    throw std::logic_error("ThreadPool cannot be configured from its tasks");
+  }
+  std::unique_lock<std::shared_mutex> lock(configMutex_);
+  stop();
+  options_ = options;
+  start();
+}
+
+size_t ThreadPool::size() const { return workers_.size(); }
+
+ThreadPoolOptions ThreadPool::getOptions() const { return options_; }
+
+bool ThreadPool::isWorker() const { return currentPool == this; }
+
+void ThreadPool::start() {
+  unsigned threads = options_.threads;
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  threads = std::max(threads, 1u);
+
+  stopping_.store(false);
+  workers_.clear();
+  for (unsigned i = 0; i < threads; ++i)
+    workers_.push_back(std::make_unique<Worker>());
+  // Started once all deques exist: workers steal from each other
+  for (unsigned i = 0; i < threads; ++i)
+    workers_[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+}
+
+void ThreadPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stopping_.store(true);
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable())
+      worker->thread.join();
+  }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+  currentPool = this;
+  currentIndex = index;
+  if (options_.pinThreads) {
+    pinToCpu(index);
+  }
+
+  uint64_t seed = 0x9E3779B97F4A7C15ull * (index + 1);
+  Backoff backoff;
+  for (;;) {
+    if (Job *job = take(index, seed)) {
+      execute(job);
+      backoff.reset();
+      continue;
+    }
+    if (queued_.load() > 0) {
+      backoff.pause(); // A task is being pushed or raced for
+      continue;
+    }
+    if (stopping_.load()) {
+      break; // Drained
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    sleeping_.fetch_add(1);
+    wake_.wait(lock, [this] { return stopping_.load() || queued_.load() > 0; });
+    sleeping_.fetch_sub(1);
+  }
+
+  currentPool = nullptr;
+  currentIndex = NO_WORKER;
+}
+
+void ThreadPool::post(std::function<void()> function) {
+  submit(new Job{std::move(function), nullptr});
+}
+
+void ThreadPool::submit(Job *job) {
+  // Counted first, so a worker never sees an empty count with work queued
+  queued_.fetch_add(1);
+  if (isWorker()) {
+    workers_[currentIndex]->deque.push(job);
+  } else {
+    std::lock_guard<std::mutex> lock(injectMutex_);
+    injected_.push_back(job);
+  }
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    wake_.notify_one();
+  }
+}
+
+ThreadPool::Job *ThreadPool::take(size_t self, uint64_t &seed) {
+  Job *job = nullptr;
+  if (self != NO_WORKER) {
+    job = workers_[self]->deque.pop();
+  }
+
+  // Steal the oldest job of a victim, starting at a random one
+  const size_t count = workers_.size();
+  if (!job && queued_.load(std::memory_order_relaxed) > 0) {
+    size_t start = static_cast<size_t>(nextRandom(seed) % count);
+    for (size_t k = 0; k < count && !job; ++k) {
+      size_t victim = (start + k) % count;
+      if (victim != self)
+        job = workers_[victim]->deque.steal();
+    }
+  }
+
+  if (!job && queued_.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(injectMutex_);
+    if (!injected_.empty()) {
+      job = injected_.front();
+      injected_.pop_front();
+    }
+  }
+
+  if (job) {
+    queued_.fetch_sub(1);
+  }
+  return job;
+}
+
+bool ThreadPool::runOne() {
+  thread_local uint64_t seed =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+  Job *job;
+  if (isWorker()) {
+    job = take(currentIndex, seed);
+  } else {
+    // Outside the pool, workers_ is only stable under the shared lock
+    std::shared_lock<std::shared_mutex> lock(configMutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      job = take(NO_WORKER, seed);
+    } else {
+      std::lock_guard<std::mutex> inject(injectMutex_);
+      job = injected_.empty() ? nullptr : injected_.front();
+      if (job) {
+        injected_.pop_front();
+        queued_.fetch_sub(1);
+      }
+    }
+  }
+  if (!job) {
+    return false;
+  }
+  execute(job);
+  return true;
+}
+
+void ThreadPool::execute(Job *job) {
+  std::unique_ptr<Job> owned(job);
+  std::exception_ptr error;
+  try {
+    owned->run();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  if (owned->group) {
+    owned->group->finish(error);
+  }
+}
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool_(pool) {}
+
+TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {
+  }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+  pending_.fetch_add(1);
+  pool_.submit(new ThreadPool::Job{std::move(task), this});
+}
+
+void TaskGroup::wait() {
+  Backoff backoff;
+  while (pending_.load(std::memory_order_acquire) > 0) {
+    if (pool_.runOne()) {
+      backoff.reset();
+    } else {
+      backoff.pause(); // Remaining tasks are running elsewhere
+    }
+  }
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGroup::finish(std::exception_ptr error) {
+  if (error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    if (!error_)
+      error_ = error;
+  }
+  // Last access: the group may be destroyed as soon as pending_ drops
+  pending_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+} // namespace guardian
@@ -0,0 +1,271 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * WorkDeque - Chase-Lev work-stealing deque of task pointers
+ *
+ * The owning worker pushes and pops at the bottom without locks; other
+ * threads steal from the top with one CAS. The ring doubles when full;
+ * replaced rings are kept until the deque is destroyed, since a thief may
+ * still be reading one (Le et al., "Correct and Efficient Work-Stealing
+ * for Weak Memory Models", 2013).
+ */
+template <typename T> class WorkDeque {
+public:
+  explicit WorkDeque(size_t capacity = 256) {
+    size_t size = 2;
+    while (size < capacity)
+      size *= 2;
+    rings_.push_back(std::make_unique<Ring>(size));
+    ring_.store(rings_.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkDeque(const WorkDeque &) = delete;
+  WorkDeque &operator=(const WorkDeque &) = delete;
+
+  /**
+   * Push at the bottom (owner only)
+   */
+  void push(T *item) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Ring *ring = ring_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(ring->mask)) {
+      ring = grow(ring, t, b);
+    }
+    ring->put(b, item);
+    bottom_.store(b + 1, std::memory_order_release); // Publishes the item
+  }
+
+  /**
+   * Pop the most recently pushed item (owner only)
+   * @return nullptr if empty
+   */
+  T *pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring *ring = ring_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    T *item = nullptr;
+    if (t <= b) {
+      item = ring->get(b);
+      if (t == b) {
+        // Last item: race thieves for it
+        if (!top_.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+          item = nullptr;
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  /**
+   * Take the oldest item (any thread)
+   * @return nullptr if empty or another thread won the race
+   */
+  T *steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    Ring *ring = ring_.load(std::memory_order_acquire);
+    T *item = ring->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return nullptr;
+    return item;
+  }
+
+  bool empty() const {
+    return top_.load(std::memory_order_acquire) >=
+           bottom_.load(std::memory_order_acquire);
+  }
+
+private:
+  struct Ring {
+    size_t mask;
+    std::unique_ptr<std::atomic<T *>[]> slots;
+
+    explicit Ring(size_t size)
+        : mask(size - 1), slots(std::make_unique<std::atomic<T *>[]>(size)) {}
+
+    T *get(int64_t i) const {
+      return slots[static_cast<size_t>(i) & mask].load(
+          std::memory_order_relaxed);
+    }
+    void put(int64_t i, T *item) {
+      slots[static_cast<size_t>(i) & mask].store(item,
+                                                 std::memory_order_relaxed);
+    }
+  };
+
+  Ring *grow(Ring *ring, int64_t t, int64_t b) {
+    auto bigger = std::make_unique<Ring>(2 * (ring->mask + 1));
+    for (int64_t i = t; i < b; ++i)
+      bigger->put(i, ring->get(i));
+    rings_.push_back(std::move(bigger));
+    ring_.store(rings_.back().get(), std::memory_order_release);
+    return rings_.back().get();
+  }
+
+  static constexpr size_t CACHE_LINE = 64;
+
+  alignas(CACHE_LINE) std::atomic<int64_t> top_{0};
+  alignas(CACHE_LINE) std::atomic<int64_t> bottom_{0};
+  std::atomic<Ring *> ring_{nullptr};
+  std::vector<std::unique_ptr<Ring>> rings_; // Owner only
+};
+
+class TaskGroup;
+
+/**
+ * ThreadPoolOptions - Size and placement of the shared workers
+ */
+struct ThreadPoolOptions {
+  unsigned threads = 0;    // 0 = one per hardware thread
+  bool pinThreads = false; // Bind worker i to the i-th allowed CPU (Linux)
+};
+
+/**
+ * ThreadPool - Process-wide work-stealing scheduler
+ *
+ * Every parallel component submits to the one instance() through a
+ * TaskGroup, so concurrent requests share a fixed set of workers instead
+ * of each starting its own threads. A worker pushes the tasks it spawns
+ * onto its own WorkDeque and pops them newest first; idle workers steal
+ * the oldest tasks of random victims. Tasks submitted from outside the
+ * pool go through a shared injection queue.
+ *
+ * Waiting never blocks a thread while work is pending: TaskGroup::wait()
+ * runs queued tasks (its own or others') until its group is done. Nested
+ * parallelism (documents -> pages -> chunks) therefore neither deadlocks
+ * nor adds threads, and a group waited for from outside the pool also
+ * makes progress with the caller's help.
+ */
+class ThreadPool {
+public:
+  explicit ThreadPool(const ThreadPoolOptions &options = ThreadPoolOptions());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * The shared pool, started on first use
+   */
+  static ThreadPool &instance();
+
+  /**
+   * Restart the workers with new options, after running queued tasks
+   * @throws std::logic_error if called from a task of this pool
+   */
+  void configure(const ThreadPoolOptions &options);
+
+  size_t size() const;
+
+  ThreadPoolOptions getOptions() const;
+
+  /**
+   * Whether the calling thread is a worker of this pool
+   */
+  bool isWorker() const;
+
+  /**
+   * Run a function on the pool without waiting for it (coroutine
+   * resumption); it must not throw
+   */
+  void post(std::function<void()> function);
+
+private:
+  friend class TaskGroup;
+
+  struct Job {
+    std::function<void()> run;
+    TaskGroup *group; // nullptr for post()
+  };
+
+  struct Worker {
+    WorkDeque<Job> deque;
+    std::thread thread;
+  };
+
+  ThreadPoolOptions options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::shared_mutex configMutex_; // Exclusive while workers_ changes
+
+  std::mutex injectMutex_;
+  std::deque<Job *> injected_;
+
+  std::atomic<size_t> queued_{0}; // Jobs in deques or injected_
+  std::atomic<unsigned> sleeping_{0};
+  std::atomic<bool> stopping_{false};
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+
+  void start();
+  void stop();
+  void workerLoop(size_t index);
+  void submit(Job *job);
+  Job *take(size_t self, uint64_t &seed);
+  bool runOne();
+  void execute(Job *job);
+};
+
+/**
+ * TaskGroup - Tasks run on a ThreadPool and waited for together
+ *
+ * The first exception thrown by a task is rethrown by wait(); the
+ * destructor waits but discards errors.
+ */
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool = ThreadPool::instance());
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  void run(std::function<void()> task);
+
+  /**
+   * Help run tasks until every task of the group has finished
+   */
+  void wait();
+
+private:
+  friend class ThreadPool;
+
+  ThreadPool &pool_;
+  std::atomic<size_t> pending_{0};
+  std::mutex errorMutex_;
+  std::exception_ptr error_;
+
+  void finish(std::exception_ptr error);
+};
+
+} // namespace guardian
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,204 @@
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace guardian {
+
+namespace {
+
+enum class CharClass {
+  Other,     // Part of an ordinary word
+  Separator, // U+3000 ideographic space
+  Ideograph, // One token per character
+  Cluster,   // Base letter of a no-space abugida
+  Mark       // Attaches to the preceding token
+};
+
+struct Range {
+  uint32_t first;
+  uint32_t last;
+};
+
+// Combining vowel signs, tone marks and viramas
+constexpr Range MARKS[] = {
+    {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, // Thai
+    {0x0EB1, 0x0EB1}, {0x0EB4, 0x0EBC}, {0x0EC8, 0x0ECD}, // Lao
+    {0x102B, 0x103E}, {0x1056, 0x1059}, {0x105E, 0x1060}, // Myanmar
+    {0x1062, 0x1064}, {0x1067, 0x106D}, {0x1071, 0x1074},
+    {0x1082, 0x108D}, {0x108F, 0x108F}, {0x109A, 0x109D},
+    {0x17B4, 0x17D3}, {0x17DD, 0x17DD},                   // Khmer
+    {0x3099, 0x309A},                                     // Kana voicing
+};
+
+bool isMark(uint32_t cp) {
+  for (const Range &r : MARKS) {
+    if (cp < r.first)
+      return false;
+    if (cp <= r.last)
+      return true;
+  }
+  return false;
+}
+
+CharClass classify(uint32_t cp) {
+  if (cp < 0x0E00)
+    return CharClass::Other;
+  if (isMark(cp))
+    return CharClass::Mark;
+  if (cp <= 0x0EFF ||                   // Thai, Lao
+      (cp >= 0x1000 && cp <= 0x109F) || // Myanmar
+      (cp >= 0x1780 && cp <= 0x17FF))   // Khmer
+    return CharClass::Cluster;
+  if (cp == 0x3000)
+    return CharClass::Separator;
+  if ((cp >= 0x2E80 && cp <= 0x2FDF) ||  // Radicals
+      (cp >= 0x3001 && cp <= 0x312F) ||  // CJK punctuation, kana, bopomofo
+      (cp >= 0x31A0 && cp <= 0x31FF) ||  // Bopomofo ext., strokes, kana ext.
+      (cp >= 0x3400 && cp <= 0x4DBF) ||  // Extension A
+      (cp >= 0x4E00 && cp <= 0x9FFF) ||  // Unified ideographs
+      (cp >= 0xF900 && cp <= 0xFAFF) ||  // Compatibility ideographs
+      (cp >= 0xFF61 && cp <= 0xFF9F) ||  // Halfwidth punctuation, katakana
+      (cp >= 0x20000 && cp <= 0x3FFFF)) // Supplementary ideographs
+    return CharClass::Ideograph;
+  return CharClass::Other;
+}
+
+// Thai/Lao leading vowels and Myanmar/Khmer subscript signs bind to the
+// following base letter
+bool joinsNext(uint32_t cp) {
+  return (cp >= 0x0E40 && cp <= 0x0E44) || (cp >= 0x0EC0 && cp <= 0x0EC4) ||
+         cp == 0x1039 || cp == 0x17D2;
+}
+
+// Decode the code point at p[i]; len is set to the bytes consumed.
+// Ill-formed bytes decode as themselves with length 1.
+uint32_t decode(const unsigned char *p, size_t i, size_t end, size_t &len) {
+  unsigned char c = p[i];
+  len = 1;
+  if (c < 0xC0)
+    return c;
+  size_t need = c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+  if (i + need > end)
+    return c;
+  uint32_t cp = c & (0x3F >> (need - 1));
+  for (size_t k = 1; k < need; ++k) {
+    if ((p[i + k] & 0xC0) != 0x80)
+      return c;
+    cp = (cp << 6) | (p[i + k] & 0x3F);
+  }
+  len = need;
+  return cp;
+}
+
+// Split one whitespace-delimited word that may contain no-space scripts
+void segmentWord(const unsigned char *p, size_t begin, size_t end,
+                 std::vector<Tokenizer::Span> &out) {
+  size_t tokenBegin = begin;
+  size_t tokenEnd = begin; // Empty when no token is open
+  CharClass tokenClass = CharClass::Other;
+  bool joinNext = false;
+
+  auto flush = [&]() {
+    if (tokenEnd > tokenBegin)
+      out.emplace_back(tokenBegin, tokenEnd);
+  };
+
+  for (size_t i = begin; i < end;) {
+    size_t len;
+    uint32_t cp = decode(p, i, end, len);
+    CharClass cls = classify(cp);
+    bool open = tokenEnd > tokenBegin;
+
+    bool extend;
+    switch (cls) {
+    case CharClass::Other:
+      extend = open && tokenClass == CharClass::Other;
+      break;
+    case CharClass::Cluster:
+      extend = open && tokenClass == CharClass::Cluster && joinNext;
+      break;
+    case CharClass::Mark:
+      extend = open;
+      break;
+    default:
+      extend = false;
+      break;
+    }
+
+    if (extend) {
+      tokenEnd = i + len;
+    } else {
+      flush();
+      tokenBegin = i;
+      tokenEnd = cls == CharClass::Separator ? i : i + len;
+      tokenClass = cls == CharClass::Mark ? CharClass::Cluster : cls;
+    }
+    joinNext = joinsNext(cp);
+    i += len;
+  }
+  flush();
+}
+
+} // namespace
+
+void Tokenizer::split(const char *data, size_t size, std::vector<Span> &out) {
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+  size_t i = 0;
+
+  while (i < size) {
+    while (i < size && isSpace(data[i]))
+      ++i;
+    size_t begin = i;
+    // Code points from U+0800 up start with a byte >= 0xE0; every script
+    // segmented here lies in that range
+    bool wide = false;
+    while (i < size && !isSpace(data[i])) {
+      wide |= p[i] >= 0xE0;
+      ++i;
+    }
+    if (i == begin)
+      continue;
+    if (wide)
+      segmentWord(p, begin, i, out);
+    else
+      out.emplace_back(begin, i);
+  }
+}
+
+std::vector<Tokenizer::Span> Tokenizer::split(const std::string &text) {
+  std::vector<Span> spans;
+  split(text.data(), text.size(), spans);
+  return spans;
+}
+
+std::string Tokenizer::join(const std::string &text,
+                            const std::vector<Span> &spans, size_t start,
+                            size_t end) {
+  std::string result;
+  end = std::min(end, spans.size());
+  if (start >= end) {
+    return result;
+  }
+
+  size_t bytes = 0;
+  for (size_t i = start; i < end; ++i)
+    bytes += spans[i].second - spans[i].first + 1;
+  result.reserve(bytes);
+
+  for (size_t i = start; i < end; ++i) {
+    if (i > start && spans[i].first > spans[i - 1].second)
+      result += ' ';
+    result.append(text, spans[i].first, spans[i].second - spans[i].first);
+  }
+
+  return result;
+}
+
+std::vector<std::string> Tokenizer::tokenize(const std::string &text) {
+  std::vector<std::string> tokens;
+  for (const auto &[begin, end] : split(text))
+    tokens.emplace_back(text, begin, end - begin);
+  return tokens;
+}
+
+} // namespace guardian
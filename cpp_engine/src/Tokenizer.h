@@ -0,0 +1,61 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * Tokenizer - Word segmentation shared by chunking and deduplication
+ *
+ * Words are separated by ASCII whitespace (the operator>> set). Scripts
+ * written without spaces are further split by code point range:
+ *  - Han, kana, bopomofo and CJK punctuation yield one token per
+ *    character (plus any combining voicing marks);
+ *  - Thai, Lao, Myanmar and Khmer yield one token per grapheme cluster
+ *    (base letter with its vowel and tone marks, leading vowels and
+ *    subscript consonants attached).
+ * Hangul is left to whitespace, as Korean is written with spaces.
+ *
+ * Only words containing a byte >= 0xE0 are decoded, so Latin-script text
+ * costs a single extra compare per byte.
+ */
+class Tokenizer {
+public:
+  using Span = std::pair<size_t, size_t>; // [begin, end) byte offsets
+
+  // Same separator set as operator>> in the C locale
+  static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+  }
+
+  /**
+   * Append the token spans of a UTF-8 buffer to out
+   */
+  static void split(const char *data, size_t size, std::vector<Span> &out);
+
+  static std::vector<Span> split(const std::string &text);
+
+  /**
+   * Rebuild the text of tokens [start, end). Tokens that were separated
+   * by whitespace are joined with one space; adjacent tokens (inside a
+   * CJK run) are joined directly. An empty or out-of-range window gives
+   * an empty string.
+   */
+  static std::string join(const std::string &text,
+                          const std::vector<Span> &spans, size_t start,
+                          size_t end);
+
+  /**
+   * Convenience: tokens as strings
+   */
+  static std::vector<std::string> tokenize(const std::string &text);
+};
+
+} // namespace guardian
+
+#endif // TOKENIZER_H
@@ -0,0 +1,273 @@
+#include "Utf8Validator.h"
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__GNUC__) || defined(__clang__))
+#define GUARDIAN_UTF8_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+namespace guardian {
+
+namespace {
+
+const char REPLACEMENT[] = "\xEF\xBF\xBD"; // U+FFFD
+
+// Examine the sequence at p. Returns its length if well-formed, otherwise
+// the length of its maximal ill-formed subpart (at least 1).
+size_t scanSequence(const unsigned char *p, size_t avail, bool &valid) {
+  unsigned char c = p[0];
+  valid = true;
+  if (c < 0x80) {
+    return 1;
+  }
+
+  size_t len;
+  unsigned char lo = 0x80, hi = 0xBF; // Allowed range of the second byte
+  if (c >= 0xC2 && c <= 0xDF) {
+    len = 2;
+  } else if (c >= 0xE0 && c <= 0xEF) {
+    len = 3;
+    lo = c == 0xE0 ? 0xA0 : 0x80; // Overlong
+    hi = c == 0xED ? 0x9F : 0xBF; // Surrogates
+  } else if (c >= 0xF0 && c <= 0xF4) {
+    len = 4;
+    lo = c == 0xF0 ? 0x90 : 0x80; // Overlong
+    hi = c == 0xF4 ? 0x8F : 0xBF; // Above U+10FFFF
+  } else {
+    valid = false;
+    return 1;
+  }
+
+  for (size_t i = 1; i < len; ++i) {
+    if (i >= avail || p[i] < lo || p[i] > hi) {
+      valid = false;
+      return i;
+    }
+    lo = 0x80;
+    hi = 0xBF;
+  }
+  return len;
+}
+
+// Scalar validation from a character boundary; returns the offset of the
+// first ill-formed byte, or n.
+size_t scalarFirstError(const unsigned char *p, size_t n, size_t pos) {
+  while (pos < n) {
+    // Skip ASCII eight bytes at a time
+    if (pos + 8 <= n) {
+      uint64_t word;
+      std::memcpy(&word, p + pos, 8);
+      if ((word & 0x8080808080808080ULL) == 0) {
+        pos += 8;
+        continue;
+      }
+    }
+    bool valid;
+    size_t len = scanSequence(p + pos, n - pos, valid);
+    if (!valid) {
+      return pos;
+    }
+    pos += len;
+  }
+  return n;
+}
+
+#if GUARDIAN_UTF8_SSSE3
+
+// Error bits of the Keiser-Lemire classification
+constexpr char TOO_SHORT = 1 << 0;
+constexpr char TOO_LONG = 1 << 1;
+constexpr char OVERLONG_3 = 1 << 2;
+constexpr char TOO_LARGE = 1 << 3;
+constexpr char SURROGATE = 1 << 4;
+constexpr char OVERLONG_2 = 1 << 5;
+constexpr char TOO_LARGE_1000 = 1 << 6;
+constexpr char OVERLONG_4 = 1 << 6;
+constexpr char TWO_CONTS = static_cast<char>(1 << 7);
+constexpr char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+__attribute__((target("ssse3"))) inline __m128i
+highNibbles(__m128i v) {
+  return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+}
+
+__attribute__((target("ssse3"))) __m128i checkBlock(__m128i input,
+                                                    __m128i prevInput) {
+  const __m128i byte1High = _mm_setr_epi8(
+      // 0xxx: ASCII followed by anything
+      TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+      TOO_LONG,
+      // 10xx: continuation
+      TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+      // 1100, 1101: two-byte lead
+      TOO_SHORT | OVERLONG_2, TOO_SHORT,
+      // 1110: three-byte lead
+      TOO_SHORT | OVERLONG_3 | SURROGATE,
+      // 1111: four-byte lead
+      TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+
+  const __m128i byte1Low = _mm_setr_epi8(
+      CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY,
+      CARRY, CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+      CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+      CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+      CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+      CARRY | TOO_LARGE | TOO_LARGE_1000,
+      CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+      CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+
+  const __m128i byte2High = _mm_setr_epi8(
+      // 0xxx: ASCII after a lead
+      TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+      TOO_SHORT, TOO_SHORT,
+      // 1000, 1001, 101x: continuation
+      TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+          OVERLONG_4,
+      TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+      TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+      TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+      // 11xx: lead after a lead
+      TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+  __m128i prev1 = _mm_alignr_epi8(input, prevInput, 15);
+  __m128i lowNibbles = _mm_and_si128(prev1, _mm_set1_epi8(0x0F));
+  __m128i sc = _mm_and_si128(
+      _mm_and_si128(_mm_shuffle_epi8(byte1High, highNibbles(prev1)),
+                    _mm_shuffle_epi8(byte1Low, lowNibbles)),
+      _mm_shuffle_epi8(byte2High, highNibbles(input)));
+
+  // Bytes two and three after a 3- or 4-byte lead must be continuations
+  __m128i prev2 = _mm_alignr_epi8(input, prevInput, 14);
+  __m128i prev3 = _mm_alignr_epi8(input, prevInput, 13);
+  __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80));
+  __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80));
+  __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth),
+                                 _mm_set1_epi8(static_cast<char>(0x80)));
+  return _mm_xor_si128(must23, sc);
+}
+
+// Nonzero where the block ends inside a multi-byte sequence
+__attribute__((target("ssse3"))) __m128i incompleteTail(__m128i input) {
+  const __m128i maxValue = _mm_setr_epi8(
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+      static_cast<char>(0xC0 - 1));
+  return _mm_subs_epu8(input, maxValue);
+}
+
+struct BlockState {
+  __m128i prev;
+  __m128i prevIncomplete;
+};
+
+// Validate one block against the state of the previous one; true on error
+__attribute__((target("ssse3"))) bool stepBlock(BlockState &state,
+                                                __m128i input) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i error;
+  if (_mm_movemask_epi8(input) == 0) {
+    error = state.prevIncomplete;
+    state.prevIncomplete = zero;
+  } else {
+    error = checkBlock(input, state.prev);
+    state.prevIncomplete = incompleteTail(input);
+  }
+  state.prev = input;
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF;
+}
+
+// Errors in a block may start up to three bytes into the previous one, so
+// resume scalar decoding at the start of that block (on a boundary).
+size_t restartPoint(const unsigned char *p, size_t block) {
+  size_t pos = block >= 16 ? block - 16 : 0;
+  for (int k = 0; k < 3 && pos > 0 && (p[pos] & 0xC0) == 0x80; ++k)
+    --pos;
+  return pos;
+}
+
+// Returns n if valid, otherwise a character boundary at or before the first
+// error from which scalar decoding will reach it.
+__attribute__((target("ssse3"))) size_t
+firstSuspectSsse3(const unsigned char *p, size_t n) {
+  BlockState state{_mm_setzero_si128(), _mm_setzero_si128()};
+
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+    if (stepBlock(state, input))
+      return restartPoint(p, i);
+  }
+
+  // Zero padding is ASCII, so a truncated final sequence reports TOO_SHORT
+  unsigned char tail[16] = {0};
+  std::memcpy(tail, p + i, n - i);
+  if (stepBlock(state, _mm_loadu_si128(reinterpret_cast<__m128i *>(tail))))
+    return restartPoint(p, i);
+
+  return n;
+}
+
+#endif // GUARDIAN_UTF8_SSSE3
+
+size_t firstSuspect(const unsigned char *p, size_t n) {
+#if GUARDIAN_UTF8_SSSE3
+  static const bool haveSsse3 = __builtin_cpu_supports("ssse3");
+  if (haveSsse3) {
+    return firstSuspectSsse3(p, n);
+  }
+#endif
+  return scalarFirstError(p, n, 0);
+}
+
+} // namespace
+
+Utf8Validator::Utf8Validator() { resetStats(); }
+
+void Utf8Validator::resetStats() { stats_ = {0, 0, 0}; }
+
+bool Utf8Validator::validate(const char *data, size_t size) {
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+  return firstSuspect(p, size) == size;
+}
+
+size_t Utf8Validator::repair(std::string &text) {
+  const size_t n = text.size();
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(text.data());
+  stats_.bytesChecked += n;
+
+  size_t start = firstSuspect(p, n);
+  if (start == n) {
+    return 0;
+  }
+  size_t error = scalarFirstError(p, n, start);
+  if (error == n) {
+    return 0;
+  }
+
+  // Rewrite only the tail; U+FFFD may be longer than what it replaces
+  std::string tail;
+  tail.reserve(n - error + 16);
+  size_t replaced = 0;
+  for (size_t pos = error; pos < n;) {
+    bool valid;
+    size_t len = scanSequence(p + pos, n - pos, valid);
+    if (valid) {
+      tail.append(text, pos, len);
+    } else {
+      tail.append(REPLACEMENT, 3);
+      ++replaced;
+    }
+    pos += len;
+  }
+
+  text.resize(error);
+  text += tail;
+
+  ++stats_.buffersRepaired;
+  stats_.sequencesReplaced += replaced;
+  return replaced;
+}
+
+} // namespace guardian
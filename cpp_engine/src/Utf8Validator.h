@@ -0,0 +1,56 @@
+#ifndef UTF8_VALIDATOR_H
+#define UTF8_VALIDATOR_H
+
+#include <cstddef>
+#include <string>
+
+namespace guardian {
+
+/**
+ * Utf8Validator - Vectorized UTF-8 validation with U+FFFD repair
+ *
+ * Validation uses the lookup-table algorithm of Keiser and Lemire
+ * ("Validating UTF-8 In Less Than One Instruction Per Byte"): three
+ * nibble lookups classify every byte pair, and a saturating subtract
+ * checks 3- and 4-byte continuations. It runs 16 bytes per step with
+ * SSSE3 (selected at runtime) and skips pure-ASCII blocks outright.
+ *
+ * Repair follows the Unicode "maximal subpart" practice: every maximal
+ * ill-formed subsequence becomes one U+FFFD. The valid prefix is never
+ * touched; only the tail from the first error onwards is rewritten.
+ */
+class Utf8Validator {
+public:
+  Utf8Validator();
+
+  /**
+   * Check whether a buffer is well-formed UTF-8
+   */
+  static bool validate(const char *data, size_t size);
+
+  /**
+   * Replace ill-formed sequences with U+FFFD
+   * @param text Buffer to repair; unchanged if already valid
+   * @return Number of replacement characters inserted
+   */
+  size_t repair(std::string &text);
+
+  /**
+   * Statistics accumulated since construction or the last resetStats()
+   */
+  struct Stats {
+    size_t bytesChecked;
+    size_t buffersRepaired;
+    size_t sequencesReplaced;
+  };
+
+  Stats getStats() const { return stats_; }
+  void resetStats();
+
+private:
+  Stats stats_;
+};
+
+} // namespace guardian
+
+#endif // UTF8_VALIDATOR_H
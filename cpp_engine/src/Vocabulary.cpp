@@ -0,0 +1,84 @@
+#include "Vocabulary.h"
+#include "CaseFolder.h"
+#include "Tokenizer.h"
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+namespace guardian {
+
+uint32_t Vocabulary::intern(std::string_view word) {
+  size_t shardIndex = std::hash<std::string_view>()(word) & SHARD_MASK;
+  Shard &shard = shards_[shardIndex];
+
+  {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.ids.find(word);
+    if (it != shard.ids.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  auto it = shard.ids.find(word); // Another thread may have added it
+  if (it != shard.ids.end()) {
+    return it->second;
+  }
+  if (shard.words.size() >= (NONE >> SHARD_BITS)) {
+    throw std::length_error("Vocabulary shard is full");
+  }
+  uint32_t id = static_cast<uint32_t>(shard.words.size() << SHARD_BITS) |
+                static_cast<uint32_t>(shardIndex);
+  shard.words.emplace_back(word);
+  shard.ids.emplace(shard.words.back(), id);
+  return id;
+}
+
+uint32_t Vocabulary::find(std::string_view word) const {
+  const Shard &shard =
+      shards_[std::hash<std::string_view>()(word) & SHARD_MASK];
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
+  auto it = shard.ids.find(word);
+  return it != shard.ids.end() ? it->second : NONE;
+}
+
+std::string_view Vocabulary::word(uint32_t id) const {
+  const Shard &shard = shards_[id & SHARD_MASK];
+  size_t index = id >> SHARD_BITS;
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
+  if (id == NONE || index >= shard.words.size()) {
+    throw std::out_of_range("Unknown word id");
+  }
+  return shard.words[index];
+}
+
+size_t Vocabulary::size() const {
+  size_t total = 0;
+  for (const Shard &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    total += shard.words.size();
+  }
+  return total;
+}
+
+void Vocabulary::encode(const char *data, size_t size,
+                        std::vector<uint32_t> &ids) {
+  thread_local std::string folded;
+  thread_local std::vector<Tokenizer::Span> words;
+  folded.clear();
+  words.clear();
+  CaseFolder::fold(data, size, folded);
+  Tokenizer::split(folded.data(), folded.size(), words);
+
+  ids.reserve(ids.size() + words.size());
+  for (const auto &[begin, end] : words)
+    ids.push_back(intern(std::string_view(folded).substr(begin, end - begin)));
+}
+
+std::vector<uint32_t> Vocabulary::encode(const std::string &text) {
+  std::vector<uint32_t> ids;
+  encode(text.data(), text.size(), ids);
+  return ids;
+}
+
+} // namespace guardian
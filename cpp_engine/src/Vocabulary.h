@@ -0,0 +1,75 @@
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * Vocabulary - Concurrent interning of normalized words to 32-bit ids
+ *
+ * Words are interned once, during tokenization, and later stages compare
+ * and hash ids instead of strings. The table is split into 64 shards by
+ * word hash, each behind a reader-writer lock, so threads interning
+ * different words rarely wait on each other and lookups of known words
+ * only take a shared lock. An id encodes its shard in the low bits; ids
+ * are stable for the lifetime of the vocabulary but not dense.
+ */
+class Vocabulary {
+public:
+  static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+  Vocabulary() = default;
+  Vocabulary(const Vocabulary &) = delete;
+  Vocabulary &operator=(const Vocabulary &) = delete;
+
+  /**
+   * Id of a word, adding it if new
+   * @throws std::length_error if a shard is full (2^26 words)
+   */
+  uint32_t intern(std::string_view word);
+
+  /**
+   * Id of a known word, or NONE
+   */
+  uint32_t find(std::string_view word) const;
+
+  /**
+   * Word of an id; valid as long as the vocabulary
+   * @throws std::out_of_range for an unknown id
+   */
+  std::string_view word(uint32_t id) const;
+
+  size_t size() const;
+
+  /**
+   * Case-fold and tokenize UTF-8 text (as Tokenizer), appending the id of
+   * each token to ids
+   */
+  void encode(const char *data, size_t size, std::vector<uint32_t> &ids);
+
+  std::vector<uint32_t> encode(const std::string &text);
+
+private:
+  static constexpr unsigned SHARD_BITS = 6;
+  static constexpr uint32_t SHARD_MASK = (1u << SHARD_BITS) - 1;
+
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> ids; // Keys view words
+    std::deque<std::string> words; // Stable addresses, indexed by id
+  };
+
+  std::array<Shard, 1u << SHARD_BITS> shards_;
+};
+
+} // namespace guardian
+
+#endif // VOCABULARY_H
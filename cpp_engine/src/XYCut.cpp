@@ -0,0 +1,233 @@
+#include "XYCut.h"
+#include <algorithm>
+
+namespace guardian {
+
+namespace {
+
+struct Box {
+  float x0, y0, x1, y1;
+  uint32_t index;
+};
+
+using BoxIter = std::vector<Box>::iterator;
+
+class Cutter {
+public:
+  Cutter(float columnGap, float blockGap, float minColumnHeight, int maxDepth,
+         ReadingOrder &out)
+      : columnGap_(columnGap), blockGap_(blockGap),
+        minColumnHeight_(minColumnHeight), maxDepth_(maxDepth), out_(out) {}
+
+  void cut(BoxIter begin, BoxIter end, int depth) {
+    if (depth < maxDepth_) {
+      std::vector<BoxIter> columns = findCuts(begin, end, true);
+      if (!columns.empty() && !hasShortPiece(begin, end, columns)) {
+        recurse(begin, end, columns, depth);
+        return;
+      }
+
+      // A heading or page number inside the gutter makes a short "column";
+      // split it off with a block cut first when there is one
+      std::vector<BoxIter> blocks = findCuts(begin, end, false);
+      if (!blocks.empty()) {
+        recurse(begin, end, blocks, depth);
+        return;
+      }
+      if (!columns.empty()) {
+        recurse(begin, end, findCuts(begin, end, true), depth);
+        return;
+      }
+    }
+    emitBlock(begin, end);
+  }
+
+private:
+  float columnGap_;
+  float blockGap_;
+  float minColumnHeight_;
+  int maxDepth_;
+  ReadingOrder &out_;
+
+  // Sort the region along one axis and return the starts of the pieces
+  // after each whitespace strip of at least the gap
+  std::vector<BoxIter> findCuts(BoxIter begin, BoxIter end, bool columns) {
+    std::vector<BoxIter> cuts;
+    if (end - begin < 2) {
+      return cuts;
+    }
+
+    float gap;
+    if (columns) {
+      std::sort(begin, end,
+                [](const Box &a, const Box &b) { return a.x0 < b.x0; });
+      gap = columnGap_;
+    } else {
+      std::sort(begin, end,
+                [](const Box &a, const Box &b) { return a.y0 < b.y0; });
+      gap = blockGap_;
+    }
+
+    // Sweep the projection; the gap is measured from the furthest extent
+    // of everything before it
+    float reach = columns ? begin->x1 : begin->y1;
+    for (BoxIter it = begin + 1; it != end; ++it) {
+      float lo = columns ? it->x0 : it->y0;
+      float hi = columns ? it->x1 : it->y1;
+      if (lo - reach >= gap)
+        cuts.push_back(it);
+      reach = std::max(reach, hi);
+    }
+    return cuts;
+  }
+
+  // True if a column piece covers too little of the region's height
+  bool hasShortPiece(BoxIter begin, BoxIter end,
+                     const std::vector<BoxIter> &cuts) const {
+    auto extent = [](BoxIter from, BoxIter to) {
+      float top = from->y0, bottom = from->y1;
+      for (BoxIter it = from; it != to; ++it) {
+        top = std::min(top, it->y0);
+        bottom = std::max(bottom, it->y1);
+      }
+      return bottom - top;
+    };
+
+    float minHeight = minColumnHeight_ * extent(begin, end);
+    BoxIter start = begin;
+    for (size_t i = 0; i <= cuts.size(); ++i) {
+      BoxIter stop = i < cuts.size() ? cuts[i] : end;
+      if (extent(start, stop) < minHeight)
+        return true;
+      start = stop;
+    }
+    return false;
+  }
+
+  void recurse(BoxIter begin, BoxIter end, const std::vector<BoxIter> &cuts,
+               int depth) {
+    BoxIter start = begin;
+    for (BoxIter c : cuts) {
+      cut(start, c, depth + 1);
+      start = c;
+    }
+    cut(start, end, depth + 1);
+  }
+
+  // Read a region without cuts line by line: a word joins the current
+  // line when its vertical centre falls inside the line's first word
+  void emitBlock(BoxIter begin, BoxIter end) {
+    if (begin == end) {
+      return;
+    }
+
+    std::sort(begin, end, [](const Box &a, const Box &b) {
+      return a.y0 + a.y1 < b.y0 + b.y1;
+    });
+
+    out_.blockStarts.push_back(static_cast<uint32_t>(out_.order.size()));
+    BoxIter line = begin;
+    for (BoxIter it = begin + 1; it != end; ++it) {
+      if ((it->y0 + it->y1) / 2 > line->y1) {
+        emitLine(line, it);
+        line = it;
+      }
+    }
+    emitLine(line, end);
+  }
+
+  void emitLine(BoxIter begin, BoxIter end) {
+    std::sort(begin, end,
+              [](const Box &a, const Box &b) { return a.x0 < b.x0; });
+    out_.lineStarts.push_back(static_cast<uint32_t>(out_.order.size()));
+    for (BoxIter it = begin; it != end; ++it)
+      out_.order.push_back(it->index);
+  }
+};
+
+} // namespace
+
+XYCut::XYCut(const XYCutOptions &options) : options_(options) {}
+
+ReadingOrder XYCut::order(const PageLayout &page) const {
+  ReadingOrder result;
+  const size_t n = page.wordCount();
+  if (n == 0) {
+    return result;
+  }
+
+  constexpr uint8_t ROTATION_MASK = 3 << PageLayout::ROTATION_SHIFT;
+  std::vector<Box> boxes;
+  std::vector<uint32_t> rotated;
+  std::vector<float> heights;
+  boxes.reserve(n);
+  heights.reserve(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    const float *b = &page.boxes[4 * i];
+    if (page.flags[i] & PageLayout::IN_TABLE) {
+      continue; // Emitted as a table chunk instead
+    }
+    if (page.flags[i] & ROTATION_MASK) {
+      rotated.push_back(static_cast<uint32_t>(i));
+      continue;
+    }
+    boxes.push_back({b[0], b[1], b[2], b[3], static_cast<uint32_t>(i)});
+    heights.push_back(b[3] - b[1]);
+  }
+
+  result.order.reserve(n);
+  if (!boxes.empty()) {
+    auto mid = heights.begin() + heights.size() / 2;
+    std::nth_element(heights.begin(), mid, heights.end());
+    float unit = *mid > 0 ? *mid : 1.0f;
+
+    Cutter cutter(options_.minColumnGap * unit, options_.minBlockGap * unit,
+                  options_.minColumnHeight, options_.maxDepth, result);
+    cutter.cut(boxes.begin(), boxes.end(), 0);
+  }
+
+  if (!rotated.empty()) {
+    auto start = static_cast<uint32_t>(result.order.size());
+    result.blockStarts.push_back(start);
+    result.lineStarts.push_back(start);
+    result.order.insert(result.order.end(), rotated.begin(), rotated.end());
+  }
+
+  return result;
+}
+
+std::string XYCut::text(const PageLayout &page, const ReadingOrder &order) {
+  std::string out;
+  out.reserve(page.text.size() + 2 * order.order.size());
+
+  size_t nextLine = 0, nextBlock = 0;
+  uint32_t prev = 0;
+  for (size_t pos = 0; pos < order.order.size(); ++pos) {
+    uint32_t w = order.order[pos];
+    bool newBlock = nextBlock < order.blockStarts.size() &&
+                    order.blockStarts[nextBlock] == pos;
+    bool newLine = nextLine < order.lineStarts.size() &&
+                   order.lineStarts[nextLine] == pos;
+    nextBlock += newBlock;
+    nextLine += newLine;
+
+    if (pos > 0) {
+      if (newBlock) {
+        out += "\n\n";
+      } else if (newLine) {
+        out += '\n';
+      } else if (w != prev + 1 ||
+                 (page.flags[prev] & PageLayout::SPACE_AFTER)) {
+        out += ' '; // Split words of one source run are rejoined directly
+      }
+    }
+    out.append(page.text, page.wordOffsets[w],
+               page.wordOffsets[w + 1] - page.wordOffsets[w]);
+    prev = w;
+  }
+
+  return out;
+}
+
+} // namespace guardian
@@ -0,0 +1,75 @@
+#ifndef XY_CUT_H
+#define XY_CUT_H
+
+#include "PageLayout.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guardian {
+
+/**
+ * XYCutOptions - Gap thresholds, as multiples of the median word height
+ */
+struct XYCutOptions {
+  float minColumnGap = 1.0f;     // Vertical strip between columns
+  float minBlockGap = 0.6f;      // Horizontal strip between blocks
+  float minColumnHeight = 0.25f; // Of the region; shorter columns defer
+                                 // to a block cut
+  int maxDepth = 32;             // Deeper regions are read as one block
+};
+
+/**
+ * ReadingOrder - Word indices of a PageLayout in reading order
+ *
+ * lineStarts and blockStarts hold positions in order where a new line or
+ * text block begins.
+ */
+struct ReadingOrder {
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> lineStarts;
+  std::vector<uint32_t> blockStarts;
+};
+
+/**
+ * XYCut - Reading-order reconstruction by recursive XY-cut
+ *
+ * A region is split at every vertical whitespace strip wider than the
+ * column gap (columns, read left to right); failing that, at every
+ * horizontal strip taller than the block gap (blocks, read top to
+ * bottom). Column cuts are tried first so that a two-column body is read
+ * column by column even where paragraph gaps line up across columns.
+ * Full-width titles block the column cut until they have been split off;
+ * a short piece inside the gutter (a centred heading or page number)
+ * makes the block cut go first. Regions without a cut are read line by
+ * line.
+ *
+ * Each level sorts the boxes of its region at most three times, so a
+ * typical page of a few hundred words takes well under 100 microseconds.
+ * Rotated words (margin stamps, vertical labels) are read last as their
+ * own block; words flagged IN_TABLE are left out.
+ */
+class XYCut {
+public:
+  explicit XYCut(const XYCutOptions &options = XYCutOptions());
+
+  /**
+   * Compute the reading order of a page's words
+   */
+  ReadingOrder order(const PageLayout &page) const;
+
+  /**
+   * Render words in reading order: words joined by spaces (or directly,
+   * where the source had no space), lines by '\n', blocks by "\n\n"
+   */
+  static std::string text(const PageLayout &page, const ReadingOrder &order);
+
+  const XYCutOptions &getOptions() const { return options_; }
+
+private:
+  XYCutOptions options_;
+};
+
+} // namespace guardian
+
+#endif // XY_CUT_H
@@ -1,6 +1,26 @@
+#include "AsyncEngine.h"
+#include "BatchReader.h"
+#include "BoilerplateFilter.h"
+#include "CaseFolder.h"
+#include "ContentScanner.h"
 #include "PDFShredder.h"
+#include "PageLayout.h"
+#include "Pipeline.h"
+#include "ProcessingPipeline.h"
 #include "RabinKarpDedup.h"
+#include "ResourceGuard.h"
+#include "SectionDetector.h"
+#include "StreamingChunker.h"
+#include "TableDetector.h"
 #include "TextChunker.h"
+#include "TextNormalizer.h"
+#include "ThreadPool.h"
+#include "Tokenizer.h"
+#include "Utf8Validator.h"
+#include "Vocabulary.h"
+#include "XYCut.h"
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -14,44 +34,343 @@ using namespace guardian;
  * @param chunkSize Words per chunk (default: 500)
  * @param overlapSize Overlapping words (default: 50)
  * @param dedup Enable deduplication (default: true)
+ * @param limits Resource limits enforced during extraction
+ * @param similarityThreshold Jaccard similarity above which chunks are
+ *        duplicates (default: 0.9)
  * @return Vector of unique text chunks ready for embedding
  */
 std::vector<std::string> process_pdf(const std::string &filepath,
                                      int chunkSize = 500, int overlapSize = 50,
-                                     bool dedup = true) {
-  // Step 1: Extract text from PDF
-  PDFShredder shredder;
-  auto pages = shredder.extractText(filepath);
-
-  // Step 2: Chunk the text
-  TextChunker chunker(chunkSize, overlapSize);
-  auto chunks = chunker.chunkMultiple(pages);
-
-  // Step 3: Deduplicate (optional)
-  if (dedup) {
-    RabinKarpDeduplicator deduplicator(0.9);
-    chunks = deduplicator.deduplicate(chunks);
-  }
-
-  return chunks;
+                                     bool dedup = true,
+                                     const ResourceLimits &limits = {},
+                                     double similarityThreshold = 0.9) {
+  // Extraction, chunking and deduplication run as overlapped stages
+  PipelineOptions options;
+  options.chunkSize = chunkSize;
+  options.overlapSize = overlapSize;
+  options.dedup = dedup;
+  options.similarityThreshold = similarityThreshold;
+  ProcessingPipeline pipeline(options, limits);
+  return pipeline.process(filepath);
+}
+
+/**
+ * Read-only numpy view of a layout column; owner keeps the storage alive
+ */
+template <typename T>
+py::array_t<T> columnView(const std::vector<T> &column,
+                          std::vector<py::ssize_t> shape, py::handle owner) {
+  py::array_t<T> view(shape, column.data(), owner);
+  view.attr("setflags")(py::arg("write") = false);
+  return view;
 }
 
 PYBIND11_MODULE(pdf_shredder, m) {
   m.doc() = "GuardianPDF - High-performance C++ PDF processing module";
 
+  // Resource limits (registered first: used as a default argument below)
+  py::class_<ResourceLimits>(m, "ResourceLimits")
+      .def(py::init<>())
+      .def_readwrite("max_stream_bytes", &ResourceLimits::maxStreamBytes)
+      .def_readwrite("max_document_bytes", &ResourceLimits::maxDocumentBytes)
+      .def_readwrite("max_objects", &ResourceLimits::maxObjects)
+      .def_readwrite("max_page_tree_depth", &ResourceLimits::maxPageTreeDepth)
+      .def_readwrite("max_page_text_bytes", &ResourceLimits::maxPageTextBytes);
+
+  py::register_exception<ResourceLimitError>(m, "ResourceLimitError");
+
   // Main processing function
   m.def("process_pdf", &process_pdf, py::arg("filepath"),
         py::arg("chunk_size") = 500, py::arg("overlap_size") = 50,
-        py::arg("dedup") = true,
+        py::arg("dedup") = true, py::arg("limits") = ResourceLimits(),
+        py::arg("similarity_threshold") = 0.9,
+        py::call_guard<py::gil_scoped_release>(),
         "Complete PDF processing pipeline: extract → chunk → deduplicate");
 
+  // Shared worker pool
+  m.def(
+      "configure_thread_pool",
+      [](unsigned threads, bool pinThreads) {
+        ThreadPoolOptions options{threads, pinThreads};
+        ThreadPool::instance().configure(options);
+      },
+      py::arg("threads") = 0, py::arg("pin_threads") = false,
+      py::call_guard<py::gil_scoped_release>(),
+      "Resize the shared worker pool (0 = hardware threads), optionally "
+      "pinning workers to CPUs");
+  m.def(
+      "thread_pool_size", []() { return ThreadPool::instance().size(); },
+      "Number of workers in the shared pool");
+
+  m.def("fold_case",
+        static_cast<std::string (*)(const std::string &)>(&CaseFolder::fold),
+        py::arg("text"), "Unicode simple case folding (Latin/Greek/Cyrillic)");
+
+  m.def("tokenize", &Tokenizer::tokenize, py::arg("text"),
+        "Split text into words; CJK/Thai runs are segmented per character");
+
   // PDFShredder class
   py::class_<PDFShredder>(m, "PDFShredder")
       .def(py::init<>())
+      .def(py::init<const ResourceLimits &>(), py::arg("limits"))
       .def("extract_text", &PDFShredder::extractText,
            "Extract text from PDF file")
+      .def("stream_text", &PDFShredder::streamText, py::arg("filepath"),
+           py::arg("on_page"),
+           "Extract text page by page, calling on_page(index, text)")
+      .def(
+          "extract_text_from_memory",
+          [](PDFShredder &self, const py::bytes &data) {
+            // Read in place: the bytes object outlives the call
+            std::string_view view = data;
+            py::gil_scoped_release release;
+            return self.extractTextFromMemory(view.data(), view.size());
+          },
+          py::arg("data"), "Extract text from PDF file contents")
       .def("get_page_count", &PDFShredder::getPageCount,
-           "Get number of pages in last processed PDF");
+           "Get number of pages in last processed PDF")
+      .def("set_limits", &PDFShredder::setLimits,
+           "Replace resource limits for subsequent extractions")
+      .def("get_limits", &PDFShredder::getLimits,
+           "Get resource limits currently in effect")
+      .def("get_scan_stats", &PDFShredder::getScanStats,
+           "Get pre-flight scan statistics for last processed PDF")
+      .def("set_reading_order", &PDFShredder::setReadingOrder,
+           py::arg("enabled"), "Order page text by XY-cut over word boxes")
+      .def("set_memory_mapping", &PDFShredder::setMemoryMapping,
+           py::arg("enabled"), "Map input files instead of reading them")
+      .def("set_normalize", &PDFShredder::setNormalize, py::arg("enabled"),
+           "Enable or disable in-place text normalization")
+      .def("set_normalize_options", &PDFShredder::setNormalizeOptions,
+           py::arg("options"), "Configure dehyphenation and line joining")
+      .def("get_normalize_stats", &PDFShredder::getNormalizeStats,
+           "Get normalization statistics for last processed PDF")
+      .def("get_utf8_stats", &PDFShredder::getUtf8Stats,
+           "Get UTF-8 repair statistics for last processed PDF")
+      .def("extract_structured", &PDFShredder::extractStructured,
+           "Extract page text with detected section headings")
+      .def("set_section_options", &PDFShredder::setSectionOptions,
+           py::arg("options"), "Configure heading detection")
+      .def("set_table_detection", &PDFShredder::setTableDetection,
+           py::arg("enabled"), "Take tables out of structured page text")
+      .def("set_table_options", &PDFShredder::setTableOptions,
+           py::arg("options"), "Configure table detection and format")
+      .def("extract_layout", &PDFShredder::extractLayout,
+           "Extract words with bounding boxes and font attributes");
+
+  // Layout structs: columns are exposed as numpy views, not per-word objects
+  py::class_<PageLayout>(m, "PageLayout")
+      .def_readonly("page_index", &PageLayout::pageIndex)
+      .def_readonly("width", &PageLayout::width)
+      .def_readonly("height", &PageLayout::height)
+      .def_property_readonly("word_count", &PageLayout::wordCount)
+      .def_property_readonly(
+          "text",
+          [](const PageLayout &self) { return py::bytes(self.text); },
+          "UTF-8 arena indexed by word_offsets")
+      .def_property_readonly(
+          "word_offsets",
+          [](py::object self) {
+            const auto &p = self.cast<const PageLayout &>();
+            return columnView(
+                p.wordOffsets,
+                {static_cast<py::ssize_t>(p.wordOffsets.size())}, self);
+          })
+      .def_property_readonly(
+          "boxes",
+          [](py::object self) {
+            const auto &p = self.cast<const PageLayout &>();
+            return columnView(
+                p.boxes, {static_cast<py::ssize_t>(p.wordCount()), 4}, self);
+          },
+          "Word boxes as (n, 4) [x0, y0, x1, y1] in points")
+      .def_property_readonly(
+          "font_sizes",
+          [](py::object self) {
+            const auto &p = self.cast<const PageLayout &>();
+            return columnView(p.fontSizes,
+                              {static_cast<py::ssize_t>(p.wordCount())}, self);
+          })
+      .def_property_readonly(
+          "font_ids",
+          [](py::object self) {
+            const auto &p = self.cast<const PageLayout &>();
+            return columnView(p.fontIds,
+                              {static_cast<py::ssize_t>(p.wordCount())}, self);
+          })
+      .def_property_readonly(
+          "flags",
+          [](py::object self) {
+            const auto &p = self.cast<const PageLayout &>();
+            return columnView(p.flags,
+                              {static_cast<py::ssize_t>(p.wordCount())}, self);
+          },
+          "Bit 0: space after word; bits 1-2: rotation / 90 degrees")
+      .def("word", &PageLayout::word, py::arg("index"), "Text of one word")
+      .def("memory_bytes", &PageLayout::memoryBytes,
+           "Bytes held by the columns");
+
+  py::class_<DocumentLayout>(m, "DocumentLayout")
+      .def_readonly("fonts", &DocumentLayout::fonts)
+      .def("__len__",
+           [](const DocumentLayout &self) { return self.pages.size(); })
+      .def(
+          "__getitem__",
+          [](const DocumentLayout &self, size_t i) -> const PageLayout & {
+            if (i >= self.pages.size())
+              throw py::index_error();
+            return self.pages[i];
+          },
+          py::return_value_policy::reference_internal)
+      .def_property_readonly("pages", [](py::object self) {
+        py::list pages;
+        for (auto &page : self.cast<DocumentLayout &>().pages)
+          pages.append(py::cast(
+              &page, py::return_value_policy::reference_internal, self));
+        return pages;
+      });
+
+  // Section structure
+  py::class_<SectionOptions>(m, "SectionOptions")
+      .def(py::init<>())
+      .def_readwrite("min_size_ratio", &SectionOptions::minSizeRatio)
+      .def_readwrite("max_heading_words", &SectionOptions::maxHeadingWords)
+      .def_readwrite("bold_headings", &SectionOptions::boldHeadings)
+      .def_readwrite("max_level", &SectionOptions::maxLevel);
+
+  py::class_<Heading>(m, "Heading")
+      .def(py::init<>())
+      .def_readwrite("level", &Heading::level)
+      .def_readwrite("title", &Heading::title)
+      .def_readwrite("page", &Heading::page)
+      .def_readwrite("offset", &Heading::offset);
+
+  py::class_<StructuredText>(m, "StructuredText")
+      .def_readonly("pages", &StructuredText::pages)
+      .def_readonly("headings", &StructuredText::headings)
+      .def_readonly("tables", &StructuredText::tables);
+
+  // Tables
+  py::enum_<TableFormat>(m, "TableFormat")
+      .value("MARKDOWN", TableFormat::Markdown)
+      .value("TSV", TableFormat::Tsv);
+
+  py::class_<TableOptions>(m, "TableOptions")
+      .def(py::init<>())
+      .def_readwrite("min_rows", &TableOptions::minRows)
+      .def_readwrite("min_columns", &TableOptions::minColumns)
+      .def_readwrite("min_cell_gap", &TableOptions::minCellGap)
+      .def_readwrite("max_row_gap", &TableOptions::maxRowGap)
+      .def_readwrite("max_cell_words", &TableOptions::maxCellWords)
+      .def_readwrite("format", &TableOptions::format);
+
+  py::class_<Table>(m, "Table")
+      .def_readonly("page", &Table::page)
+      .def_readonly("offset", &Table::offset)
+      .def_readonly("rows", &Table::rows)
+      .def_readonly("columns", &Table::columns)
+      .def_property_readonly("box",
+                             [](const Table &self) {
+                               return py::make_tuple(self.box[0], self.box[1],
+                                                     self.box[2], self.box[3]);
+                             })
+      .def_readonly("text", &Table::text);
+
+  // Reading order
+  py::class_<XYCutOptions>(m, "XYCutOptions")
+      .def(py::init<>())
+      .def_readwrite("min_column_gap", &XYCutOptions::minColumnGap)
+      .def_readwrite("min_block_gap", &XYCutOptions::minBlockGap)
+      .def_readwrite("min_column_height", &XYCutOptions::minColumnHeight)
+      .def_readwrite("max_depth", &XYCutOptions::maxDepth);
+
+  py::class_<ReadingOrder>(m, "ReadingOrder")
+      .def_property_readonly(
+          "order",
+          [](py::object self) {
+            const auto &r = self.cast<const ReadingOrder &>();
+            return columnView(
+                r.order, {static_cast<py::ssize_t>(r.order.size())}, self);
+          })
+      .def_readonly("line_starts", &ReadingOrder::lineStarts)
+      .def_readonly("block_starts", &ReadingOrder::blockStarts);
+
+  py::class_<XYCut>(m, "XYCut")
+      .def(py::init<const XYCutOptions &>(),
+           py::arg("options") = XYCutOptions())
+      .def("order", &XYCut::order, py::arg("page"),
+           "Word indices of a PageLayout in reading order")
+      .def_static("text", &XYCut::text, py::arg("page"), py::arg("order"),
+                  "Render words in reading order");
+
+  // Scan stats struct
+  py::class_<ResourceGuard::Stats>(m, "ScanStats")
+      .def_readonly("object_count", &ResourceGuard::Stats::objectCount)
+      .def_readonly("stream_count", &ResourceGuard::Stats::streamCount)
+      .def_readonly("decompressed_bytes",
+                    &ResourceGuard::Stats::decompressedBytes)
+      .def_readonly("page_tree_depth", &ResourceGuard::Stats::pageTreeDepth);
+
+  // TextNormalizer class
+  py::class_<NormalizeOptions>(m, "NormalizeOptions")
+      .def(py::init<>())
+      .def_readwrite("dehyphenate", &NormalizeOptions::dehyphenate)
+      .def_readwrite("join_lines", &NormalizeOptions::joinLines);
+
+  py::class_<TextNormalizer>(m, "TextNormalizer")
+      .def(py::init<const NormalizeOptions &>(),
+           py::arg("options") = NormalizeOptions())
+      .def("add_compound_prefix", &TextNormalizer::addCompoundPrefix,
+           py::arg("prefix"),
+           "Keep line-break hyphens after this word (e.g. 'self')")
+      .def(
+          "normalize",
+          [](TextNormalizer &self, std::string text) {
+            self.normalize(text);
+            return text;
+          },
+          py::arg("text"), "Return normalized copy of text")
+      .def("get_stats", &TextNormalizer::getStats,
+           "Get accumulated normalization statistics")
+      .def("reset_stats", &TextNormalizer::resetStats,
+           "Reset accumulated statistics");
+
+  py::class_<TextNormalizer::Stats>(m, "NormalizeStats")
+      .def_readonly("bytes_in", &TextNormalizer::Stats::bytesIn)
+      .def_readonly("bytes_out", &TextNormalizer::Stats::bytesOut)
+      .def_readonly("chars_mapped", &TextNormalizer::Stats::charsMapped)
+      .def_readonly("chars_removed", &TextNormalizer::Stats::charsRemoved)
+      .def_readonly("hyphens_joined", &TextNormalizer::Stats::hyphensJoined)
+      .def_readonly("lines_joined", &TextNormalizer::Stats::linesJoined);
+
+  // Utf8Validator class
+  py::class_<Utf8Validator>(m, "Utf8Validator")
+      .def(py::init<>())
+      .def_static(
+          "validate",
+          [](const py::bytes &data) {
+            std::string_view view = data;
+            return Utf8Validator::validate(view.data(), view.size());
+          },
+          py::arg("data"), "Check whether bytes are well-formed UTF-8")
+      .def(
+          "repair",
+          [](Utf8Validator &self, const py::bytes &data) {
+            std::string text = data;
+            self.repair(text);
+            return text;
+          },
+          py::arg("data"), "Return data as UTF-8 with U+FFFD replacements")
+      .def("get_stats", &Utf8Validator::getStats,
+           "Get accumulated validation statistics")
+      .def("reset_stats", &Utf8Validator::resetStats,
+           "Reset accumulated statistics");
+
+  py::class_<Utf8Validator::Stats>(m, "Utf8Stats")
+      .def_readonly("bytes_checked", &Utf8Validator::Stats::bytesChecked)
+      .def_readonly("buffers_repaired", &Utf8Validator::Stats::buffersRepaired)
+      .def_readonly("sequences_replaced",
+                    &Utf8Validator::Stats::sequencesReplaced);
 
   // TextChunker class
   py::class_<TextChunker>(m, "TextChunker")
@@ -59,7 +378,223 @@ PYBIND11_MODULE(pdf_shredder, m) {
            py::arg("overlap_size") = 50)
       .def("chunk", &TextChunker::chunk, "Chunk a single text block")
       .def("chunk_multiple", &TextChunker::chunkMultiple,
-           "chunk multiple text blocks");
+           "chunk multiple text blocks")
+      .def("set_thread_count", &TextChunker::setThreadCount,
+           py::arg("threads"),
+           "Tasks for chunk_multiple (0 = pool workers, 1 = serial)")
+      .def("chunk_and_scan", &TextChunker::chunkAndScan, py::arg("text"),
+           py::arg("scanner"), py::arg("redact") = false,
+           "Chunk a text block and scan chunks for PII/secrets")
+      .def("chunk_multiple_and_scan", &TextChunker::chunkMultipleAndScan,
+           py::arg("texts"), py::arg("scanner"), py::arg("redact") = false,
+           "Chunk and scan multiple text blocks")
+      .def("chunk_sections", &TextChunker::chunkSections, py::arg("pages"),
+           py::arg("headings"), py::arg("tables") = std::vector<Table>(),
+           "Chunk pages within section boundaries, with section paths")
+      .def("chunk_hierarchy",
+           py::overload_cast<const std::vector<std::string> &, int>(
+               &TextChunker::chunkHierarchy, py::const_),
+           py::arg("texts"), py::arg("parent_size"),
+           "Chunk texts into parents and nested children in one pass")
+      .def("chunk_hierarchy",
+           py::overload_cast<const std::string &, int>(
+               &TextChunker::chunkHierarchy, py::const_),
+           py::arg("text"), py::arg("parent_size"),
+           "Chunk a text into parents and nested children in one pass")
+      .def("chunk_spans",
+           py::overload_cast<const std::vector<std::string> &>(
+               &TextChunker::chunkSpans, py::const_),
+           py::arg("texts"), "Chunk texts into spans of one shared buffer")
+      .def("chunk_spans",
+           py::overload_cast<const std::string &>(&TextChunker::chunkSpans,
+                                                  py::const_),
+           py::arg("text"), "Chunk a text into spans of one shared buffer");
+
+  // ChunkSpans struct: chunk strings are built on access
+  py::class_<ChunkSpans>(m, "ChunkSpans")
+      .def("__len__", &ChunkSpans::size)
+      .def("__getitem__", &ChunkSpans::chunk, py::arg("index"))
+      .def_property_readonly(
+          "bounds",
+          [](py::object self) {
+            const auto &s = self.cast<const ChunkSpans &>();
+            return columnView(s.bounds,
+                              {static_cast<py::ssize_t>(s.size()), 2}, self);
+          },
+          "Chunk byte ranges as (n, 2) [begin, end) into text")
+      .def_property_readonly(
+          "text", [](const ChunkSpans &self) { return py::bytes(self.text); },
+          "UTF-8 buffer indexed by bounds")
+      .def(
+          "view",
+          [](const ChunkSpans &self, size_t index) {
+            std::string_view bytes = self.view(index);
+            return py::bytes(bytes.data(), bytes.size());
+          },
+          py::arg("index"), "Raw UTF-8 bytes of one chunk")
+      .def("materialize", &ChunkSpans::materialize, "All chunks as strings")
+      .def("memory_bytes", &ChunkSpans::memoryBytes,
+           "Bytes held by the buffer and bounds");
+
+  // ChunkHierarchy struct
+  py::class_<ChunkHierarchy>(m, "ChunkHierarchy")
+      .def_property_readonly("parent_count", &ChunkHierarchy::parentCount)
+      .def_property_readonly("child_count", &ChunkHierarchy::childCount)
+      .def_property_readonly(
+          "parents",
+          [](py::object self) {
+            const auto &h = self.cast<const ChunkHierarchy &>();
+            return columnView(
+                h.parents, {static_cast<py::ssize_t>(h.parentCount()), 2},
+                self);
+          },
+          "Parent word ranges as (n, 2) [start, end)")
+      .def_property_readonly(
+          "children",
+          [](py::object self) {
+            const auto &h = self.cast<const ChunkHierarchy &>();
+            return columnView(
+                h.children, {static_cast<py::ssize_t>(h.childCount()), 2},
+                self);
+          },
+          "Child word ranges as (n, 2) [start, end)")
+      .def_property_readonly(
+          "parent_of",
+          [](py::object self) {
+            const auto &h = self.cast<const ChunkHierarchy &>();
+            return columnView(h.parentOf,
+                              {static_cast<py::ssize_t>(h.childCount())},
+                              self);
+          },
+          "Parent index of each child")
+      .def("parent", &ChunkHierarchy::parent, py::arg("index"),
+           "Text of one parent chunk")
+      .def("child", &ChunkHierarchy::child, py::arg("index"),
+           "Text of one child chunk");
+
+  // StreamingChunker class
+  py::class_<StreamingChunker> streaming(m, "StreamingChunker");
+
+  py::class_<StreamingChunker::Stats>(streaming, "Stats")
+      .def_readonly("words", &StreamingChunker::Stats::words)
+      .def_readonly("chunks", &StreamingChunker::Stats::chunks)
+      .def_readonly("max_window_bytes",
+                    &StreamingChunker::Stats::maxWindowBytes);
+
+  streaming
+      .def(py::init<int, int, StreamingChunker::Callback>(),
+           py::arg("chunk_size") = 500, py::arg("overlap_size") = 50,
+           py::arg("callback") = nullptr)
+      .def("feed",
+           py::overload_cast<const std::string &>(&StreamingChunker::feed),
+           py::arg("piece"), "Add the next piece of text")
+      .def("flush", &StreamingChunker::flush,
+           "End the stream and emit the last chunk")
+      .def("take_chunks", &StreamingChunker::takeChunks,
+           "Chunks queued since the last call (no callback given)")
+      .def("get_stats", &StreamingChunker::getStats);
+
+  // SectionChunk struct
+  py::class_<SectionChunk>(m, "SectionChunk")
+      .def_readonly("text", &SectionChunk::text)
+      .def_readonly("path", &SectionChunk::path)
+      .def_readonly("page", &SectionChunk::page)
+      .def_readonly("is_table", &SectionChunk::isTable);
+
+  // ScannedChunks struct
+  py::class_<ScannedChunks>(m, "ScannedChunks")
+      .def_readonly("chunks", &ScannedChunks::chunks)
+      .def_readonly("findings", &ScannedChunks::findings)
+      .def_readonly("redacted", &ScannedChunks::redacted);
+
+  // ContentScanner class
+  py::class_<ContentScanner> scanner(m, "ContentScanner");
+
+  py::enum_<ContentScanner::Validator>(scanner, "Validator")
+      .value("NONE", ContentScanner::Validator::None)
+      .value("LUHN", ContentScanner::Validator::Luhn);
+
+  scanner.def(py::init<bool>(), py::arg("load_defaults") = true)
+      .def("add_literal", &ContentScanner::addLiteral, py::arg("rule"),
+           py::arg("category"), py::arg("literal"),
+           "Add a case-insensitive literal keyword")
+      .def("add_pattern", &ContentScanner::addPattern, py::arg("rule"),
+           py::arg("category"), py::arg("pattern"),
+           py::arg("validator") = ContentScanner::Validator::None,
+           "Add a structured pattern (regex subset)")
+      .def("scan", &ContentScanner::scan, "Scan text for all rules")
+      .def_static("redact", &ContentScanner::redact, py::arg("text"),
+                  py::arg("findings"), py::arg("mask") = '*',
+                  "Mask matched bytes, preserving word boundaries")
+      .def("rule_count", &ContentScanner::ruleCount,
+           "Get number of registered rules");
+
+  // Finding struct
+  py::class_<Finding>(m, "Finding")
+      .def_readonly("rule", &Finding::rule)
+      .def_readonly("category", &Finding::category)
+      .def_readonly("offset", &Finding::offset)
+      .def_readonly("length", &Finding::length)
+      .def_readonly("chunk_index", &Finding::chunkIndex);
+
+  // Pipelined processing
+  py::class_<PipelineOptions>(m, "PipelineOptions")
+      .def(py::init<>())
+      .def_readwrite("chunk_size", &PipelineOptions::chunkSize)
+      .def_readwrite("overlap_size", &PipelineOptions::overlapSize)
+      .def_readwrite("dedup", &PipelineOptions::dedup)
+      .def_readwrite("similarity_threshold",
+                     &PipelineOptions::similarityThreshold)
+      .def_readwrite("chunk_threads", &PipelineOptions::chunkThreads)
+      .def_readwrite("queue_capacity", &PipelineOptions::queueCapacity);
+
+  py::class_<ProcessingPipeline> pipeline(m, "ProcessingPipeline");
+
+  py::class_<ProcessingPipeline::Stats>(pipeline, "Stats")
+      .def_readonly("pages", &ProcessingPipeline::Stats::pages)
+      .def_readonly("chunks", &ProcessingPipeline::Stats::chunks)
+      .def_readonly("unique_chunks", &ProcessingPipeline::Stats::uniqueChunks)
+      .def_readonly("max_reordered", &ProcessingPipeline::Stats::maxReordered);
+
+  pipeline
+      .def(py::init<const PipelineOptions &, const ResourceLimits &>(),
+           py::arg("options") = PipelineOptions(),
+           py::arg("limits") = ResourceLimits())
+      .def("process", &ProcessingPipeline::process, py::arg("filepath"),
+           py::call_guard<py::gil_scoped_release>(),
+           "Extract, chunk and deduplicate with overlapped stages")
+      .def("get_stats", &ProcessingPipeline::getStats,
+           "Statistics of the last process() call")
+      .def_property_readonly("options", &ProcessingPipeline::getOptions)
+      .def_property_readonly("shredder", &ProcessingPipeline::shredder,
+                             py::return_value_policy::reference_internal);
+
+  m.def("process_pdfs", &processPdfs, py::arg("filepaths"),
+        py::arg("options") = PipelineOptions(),
+        py::arg("limits") = ResourceLimits(), py::arg("max_documents") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "Process documents concurrently as coroutines on the shared pool");
+
+  // Batch ingestion
+  py::class_<BatchReaderOptions>(m, "BatchReaderOptions")
+      .def(py::init<>())
+      .def_readwrite("prefetch", &BatchReaderOptions::prefetch)
+      .def_readwrite("buffer_bytes", &BatchReaderOptions::bufferBytes)
+      .def_readwrite("use_io_uring", &BatchReaderOptions::useIoUring)
+      .def_readwrite("read_threads", &BatchReaderOptions::readThreads);
+
+  py::class_<BatchDocument>(m, "BatchDocument")
+      .def_readonly("index", &BatchDocument::index)
+      .def_readonly("path", &BatchDocument::path)
+      .def_readonly("pages", &BatchDocument::pages)
+      .def_readonly("error", &BatchDocument::error);
+
+  m.def("extract_batch", &extractBatch, py::arg("paths"),
+        py::arg("on_document"), py::arg("options") = BatchReaderOptions(),
+        py::arg("limits") = ResourceLimits(),
+        py::call_guard<py::gil_scoped_release>(),
+        "Extract many PDFs, reading ahead while earlier ones are parsed; "
+        "on_document(doc) is called in list order");
 
   // RabinKarpDeduplicator class
   py::class_<RabinKarpDeduplicator>(m, "RabinKarpDeduplicator")
@@ -67,7 +602,23 @@ PYBIND11_MODULE(pdf_shredder, m) {
       .def("deduplicate", &RabinKarpDeduplicator::deduplicate,
            "Remove duplicate chunks")
       .def("get_stats", &RabinKarpDeduplicator::getStats,
-           "Get statistics from last deduplication run");
+           "Get statistics from last deduplication run")
+      .def("set_vocabulary", &RabinKarpDeduplicator::setVocabulary,
+           py::arg("vocabulary"), "Intern words into a shared vocabulary");
+
+  // Vocabulary class
+  py::class_<Vocabulary, std::shared_ptr<Vocabulary>>(m, "Vocabulary")
+      .def(py::init<>())
+      .def_readonly_static("NONE", &Vocabulary::NONE)
+      .def("intern", &Vocabulary::intern, py::arg("word"),
+           "Id of a word, adding it if new")
+      .def("find", &Vocabulary::find, py::arg("word"),
+           "Id of a known word, or NONE")
+      .def("word", &Vocabulary::word, py::arg("id"), "Word of an id")
+      .def("__len__", &Vocabulary::size)
+      .def("encode",
+           py::overload_cast<const std::string &>(&Vocabulary::encode),
+           py::arg("text"), "Ids of the case-folded tokens of a text");
 
   // Stats struct
   py::class_<RabinKarpDeduplicator::Stats>(m, "DeduplicationStats")
@@ -78,4 +629,66 @@ PYBIND11_MODULE(pdf_shredder, m) {
                     &RabinKarpDeduplicator::Stats::duplicatesRemoved)
       .def_readonly("deduplication_ratio",
                     &RabinKarpDeduplicator::Stats::deduplicationRatio);
+
+  // Boilerplate removal
+  py::class_<BoilerplateOptions>(m, "BoilerplateOptions")
+      .def(py::init<>())
+      .def_readwrite("edge_lines", &BoilerplateOptions::edgeLines)
+      .def_readwrite("min_page_fraction",
+                     &BoilerplateOptions::minPageFraction)
+      .def_readwrite("min_pages", &BoilerplateOptions::minPages)
+      .def_readwrite("max_line_bytes", &BoilerplateOptions::maxLineBytes);
+
+  py::class_<BoilerplateFilter> boilerplate(m, "BoilerplateFilter");
+
+  py::class_<BoilerplateFilter::Stats>(boilerplate, "Stats")
+      .def_readonly("patterns", &BoilerplateFilter::Stats::patterns)
+      .def_readonly("lines_removed", &BoilerplateFilter::Stats::linesRemoved);
+
+  boilerplate
+      .def(py::init<const BoilerplateOptions &>(),
+           py::arg("options") = BoilerplateOptions())
+      .def(
+          "strip",
+          [](BoilerplateFilter &self, std::vector<std::string> pages) {
+            self.strip(pages);
+            return pages;
+          },
+          py::arg("pages"), "Pages with running headers and footers removed")
+      .def("get_stats", &BoilerplateFilter::getStats,
+           "Statistics of the last strip() call")
+      .def_property_readonly("options", &BoilerplateFilter::getOptions);
+
+  // Composable pipeline
+  py::class_<PipelineResult>(m, "PipelineResult")
+      .def_readonly("chunks", &PipelineResult::chunks)
+      .def_readonly("findings", &PipelineResult::findings)
+      .def_readonly("tokens", &PipelineResult::tokens);
+
+  // Builder methods return the pipeline itself for chaining
+  const auto self = py::return_value_policy::reference;
+  py::class_<Pipeline>(m, "Pipeline")
+      .def(py::init<>())
+      .def("extract", &Pipeline::extract, py::arg("limits") = ResourceLimits(),
+           self, "Extract page text in reading order (first stage)")
+      .def("normalize", &Pipeline::normalize,
+           py::arg("options") = NormalizeOptions(), self,
+           "Normalize page text")
+      .def("strip_boilerplate", &Pipeline::stripBoilerplate,
+           py::arg("options") = BoilerplateOptions(), self,
+           "Remove running headers, footers and page numbers")
+      .def("chunk", &Pipeline::chunk, py::arg("chunk_size") = 500,
+           py::arg("overlap_size") = 50, self, "Split pages into chunks")
+      .def("dedup", &Pipeline::dedup, py::arg("similarity_threshold") = 0.9,
+           self, "Remove near-duplicate chunks")
+      .def("scan", &Pipeline::scan, py::arg("scanner"),
+           py::arg("redact") = false, self,
+           "Scan chunks for PII/secrets, optionally masking them")
+      .def("tokenize", &Pipeline::tokenize, py::arg("vocabulary") = py::none(),
+           self, "Map chunks to vocabulary ids")
+      .def("run", &Pipeline::run, py::arg("filepath"),
+           py::call_guard<py::gil_scoped_release>(), "Run on a PDF file")
+      .def("run_texts", &Pipeline::runTexts, py::arg("pages"),
+           py::call_guard<py::gil_scoped_release>(), "Run on page texts")
+      .def_property_readonly("stages", &Pipeline::stages);
 }
@@ -0,0 +1,250 @@
+/**
+ * guardian-shred - Bulk PDF chunking without Python
+ *
+ *   guardian-shred [options] <file-or-directory>...
+ *
+ * Directories are searched recursively for PDFs. Files are processed in
+ * parallel as tasks on the shared ThreadPool, sized to --jobs; each task
+ * runs its own extract, boilerplate removal, normalization, chunking and
+ * dedup Pipeline (whose chunking uses the same pool), and chunks are
+ * written as each file completes (so in completion order) as NDJSON or
+ * in the columnar format of ColumnarWriter. Per-file timing and progress
+ * go to stderr. The exit status is 1 if any file failed.
+ */
+#include "ChunkWriter.h"
+#include "Pipeline.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace guardian;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  std::vector<std::string> inputs;
+  std::string output = "-";
+  std::string format = "ndjson";
+  unsigned jobs = 0; // 0 = one per hardware thread
+  int chunkSize = 500;
+  int overlapSize = 50;
+  double similarityThreshold = 0.9;
+  bool quiet = false;
+};
+
+void usage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " [options] <file-or-directory>...\n"
+      << "  -o, --output PATH   Output file, - for stdout (default -)\n"
+      << "  --format F          ndjson or columnar (default ndjson)\n"
+      << "  -j, --jobs N        Files processed at once (all cores)\n"
+      << "  --chunk-size N      Words per chunk (500)\n"
+      << "  --overlap N         Words shared by adjacent chunks (50)\n"
+      << "  --similarity X      Near-duplicate threshold (0.9)\n"
+      << "  -q, --quiet         Print the summary only\n";
+}
+
+// @throws std::invalid_argument on a malformed command line
+Config parse(int argc, char **argv) {
+  Config config;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc)
+        throw std::invalid_argument("missing value for " + arg);
+      return argv[++i];
+    };
+    if (arg == "-o" || arg == "--output") {
+      config.output = value();
+    } else if (arg == "--format") {
+      config.format = value();
+      if (config.format != "ndjson" && config.format != "columnar")
+        throw std::invalid_argument("unknown format " + config.format);
+    } else if (arg == "-j" || arg == "--jobs") {
+      config.jobs = static_cast<unsigned>(std::max(std::stoi(value()), 1));
+    } else if (arg == "--chunk-size") {
+      config.chunkSize = std::stoi(value());
+    } else if (arg == "--overlap") {
+      config.overlapSize = std::stoi(value());
+    } else if (arg == "--similarity") {
+      config.similarityThreshold = std::stod(value());
+    } else if (arg == "-q" || arg == "--quiet") {
+      config.quiet = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      throw std::invalid_argument("unknown option " + arg);
+    } else {
+      config.inputs.push_back(arg);
+    }
+  }
+  if (config.inputs.empty()) {
+    throw std::invalid_argument("no input files");
+  }
+  return config;
+}
+
+// @throws std::invalid_argument for bad chunk sizes
+std::unique_ptr<Pipeline> makePipeline(const Config &config) {
+  auto pipeline = std::make_unique<Pipeline>();
+  pipeline->extract()
+      .stripBoilerplate()
+      .normalize()
+      .chunk(config.chunkSize, config.overlapSize)
+      .dedup(config.similarityThreshold);
+  return pipeline;
+}
+
+bool isPdf(const std::filesystem::path &path) {
+  std::string extension = path.extension().string();
+  for (char &c : extension)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return extension == ".pdf";
+}
+
+// Files as given, and the PDFs under directories in path order
+std::vector<std::string> expand(const std::vector<std::string> &inputs) {
+  namespace fs = std::filesystem;
+  std::vector<std::string> files;
+  for (const auto &input : inputs) {
+    if (!fs::is_directory(input)) {
+      files.push_back(input);
+      continue;
+    }
+    std::vector<std::string> found;
+    for (const auto &entry : fs::recursive_directory_iterator(
+             input, fs::directory_options::skip_permission_denied)) {
+      if (entry.is_regular_file() && isPdf(entry.path()))
+        found.push_back(entry.path().string());
+    }
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+  }
+  return files;
+}
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::ios::sync_with_stdio(false);
+  Config config;
+  std::vector<std::string> files;
+  std::vector<std::unique_ptr<Pipeline>> pipelines; // One per task
+  try {
+    config = parse(argc, argv);
+    files = expand(config.inputs);
+    ThreadPool &pool = ThreadPool::instance();
+    if (config.jobs) {
+      ThreadPoolOptions options = pool.getOptions();
+      options.threads = config.jobs;
+      pool.configure(options);
+    }
+    size_t jobs = std::min(pool.size(), std::max<size_t>(files.size(), 1));
+    for (size_t i = 0; i < jobs; ++i)
+      pipelines.push_back(makePipeline(config));
+  } catch (const std::invalid_argument &e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    usage(argv[0]);
+    return 2;
+  } catch (const std::exception &e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    return 1;
+  }
+
+  std::ofstream file;
+  if (config.output != "-") {
+    file.open(config.output, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      std::cerr << argv[0] << ": cannot write " << config.output << "\n";
+      return 1;
+    }
+  }
+  std::ostream &out = config.output == "-" ? std::cout : file;
+  std::unique_ptr<ChunkWriter> writer;
+  if (config.format == "columnar") {
+    writer = std::make_unique<ColumnarWriter>(out);
+  } else {
+    writer = std::make_unique<NdjsonWriter>(out);
+  }
+
+  Clock::time_point started = Clock::now();
+  std::atomic<size_t> nextFile{0};
+  std::mutex outputMutex; // Writer and progress lines
+  size_t done = 0, failed = 0, chunks = 0;
+
+  auto work = [&](Pipeline &pipeline) {
+    for (;;) {
+      size_t i = nextFile.fetch_add(1);
+      if (i >= files.size())
+        break;
+      Clock::time_point start = Clock::now();
+      PipelineResult result;
+      std::string error;
+      try {
+        result = pipeline.run(files[i]);
+      } catch (const std::exception &e) {
+        error = e.what();
+      }
+      double ms = millisecondsSince(start);
+
+      std::lock_guard<std::mutex> lock(outputMutex);
+      ++done;
+      if (error.empty()) {
+        writer->write(files[i], result.chunks);
+        chunks += result.chunks.size();
+      } else {
+        ++failed;
+      }
+      if (!config.quiet || !error.empty()) {
+        char timing[32];
+        std::snprintf(timing, sizeof(timing), "%.1f ms", ms);
+        std::cerr << "[" << done << "/" << files.size() << "] " << files[i]
+                  << "  "
+                  << (error.empty()
+                          ? std::to_string(result.chunks.size()) + " chunks"
+                          : "failed: " + error)
+                  << "  " << timing << "\n";
+      }
+    }
+  };
+
+  TaskGroup group; // The main thread helps while it waits
+  for (auto &pipeline : pipelines)
+    group.run([&work, &pipeline]() { work(*pipeline); });
+  group.wait();
+
+  writer->finish();
+  out.flush();
+  double seconds = millisecondsSince(started) / 1000;
+  char summary[160];
+  std::snprintf(summary, sizeof(summary),
+                "%zu files (%zu failed), %zu chunks in %.2f s "
+                "(%.1f files/s)\n",
+                files.size(), failed, chunks, seconds,
+                seconds > 0 ? static_cast<double>(files.size()) / seconds
+                            : 0.0);
+  std::cerr << summary;
+
+  if (!out) {
+    std::cerr << argv[0] << ": failed writing " << config.output << "\n";
+    return 1;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+/**
+ * guardian-watch - Index PDFs as they arrive in watched directories
+ *
+ *   guardian-watch [options] <store-dir> <directory>...
+ *
+ * Each completed file runs through extract, boilerplate removal,
+ * normalization, chunking and dedup as a task on the shared ThreadPool,
+ * sized to --workers, and its chunks replace its entry in the ChunkStore.
+ * Files whose entry is newer than the file are skipped, so a restart only
+ * processes what changed while the daemon was down. SIGINT/SIGTERM
+ * finish the files already queued and exit.
+ */
+#include "ChunkStore.h"
+#include "DirectoryWatcher.h"
+#include "Pipeline.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace guardian;
+
+namespace {
+
+volatile std::sig_atomic_t stopping = 0;
+
+void onSignal(int) { stopping = 1; }
+
+struct Config {
+  std::string store;
+  std::vector<std::string> directories;
+  WatchOptions watch;
+  unsigned workers = 0; // 0 = one per hardware thread
+  int chunkSize = 500;
+  int overlapSize = 50;
+  double similarityThreshold = 0.9;
+};
+
+void usage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " [options] <store-dir> <directory>...\n"
+      << "  --recursive         Watch subdirectories too\n"
+      << "  --suffix S          File name suffix to index (default .pdf)\n"
+      << "  --settle-ms N       Quiet time after a file is closed (500)\n"
+      << "  --workers N         Documents processed at once (all cores)\n"
+      << "  --chunk-size N      Words per chunk (500)\n"
+      << "  --overlap N         Words shared by adjacent chunks (50)\n"
+      << "  --similarity X      Near-duplicate threshold (0.9)\n";
+}
+
+// @throws std::invalid_argument on a malformed command line
+Config parse(int argc, char **argv) {
+  Config config;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc)
+        throw std::invalid_argument("missing value for " + arg);
+      return argv[++i];
+    };
+    if (arg == "--recursive") {
+      config.watch.recursive = true;
+    } else if (arg == "--suffix") {
+      config.watch.suffix = value();
+    } else if (arg == "--settle-ms") {
+      config.watch.settleMs = std::stoi(value());
+    } else if (arg == "--workers") {
+      config.workers = static_cast<unsigned>(std::max(std::stoi(value()), 1));
+    } else if (arg == "--chunk-size") {
+      config.chunkSize = std::stoi(value());
+    } else if (arg == "--overlap") {
+      config.overlapSize = std::stoi(value());
+    } else if (arg == "--similarity") {
+      config.similarityThreshold = std::stod(value());
+    } else if (arg.rfind("--", 0) == 0) {
+      throw std::invalid_argument("unknown option " + arg);
+    } else {
+      positional.push_back(arg);
+    }
+  }
+  if (positional.size() < 2) {
+    throw std::invalid_argument("a store and a directory are required");
+  }
+  config.store = positional[0];
+  config.directories.assign(positional.begin() + 1, positional.end());
+  return config;
+}
+
+// @throws std::invalid_argument for bad chunk sizes
+std::unique_ptr<Pipeline> makePipeline(const Config &config) {
+  auto pipeline = std::make_unique<Pipeline>();
+  pipeline->extract()
+      .stripBoilerplate()
+      .normalize()
+      .chunk(config.chunkSize, config.overlapSize)
+      .dedup(config.similarityThreshold);
+  return pipeline;
+}
+
+class Indexer {
+public:
+  /**
+   * @param first A Pipeline built on the calling thread, so that bad
+   *        options are reported before any task starts
+   */
+  Indexer(const Config &config, ChunkStore &store,
+          std::unique_ptr<Pipeline> first)
+      : config_(config), store_(store) {
+    idle_.push_back(std::move(first));
+  }
+
+  /**
+   * Queue a file; a file already queued or being indexed is indexed again
+   * once its current run finishes, never by two tasks at a time
+   */
+  void add(std::string path) {
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex_);
+      if (!pending_.insert(path).second) {
+        again_.insert(path);
+        return;
+      }
+    }
+    group_.run([this, path = std::move(path)]() { work(path); });
+  }
+
+private:
+  const Config &config_;
+  ChunkStore &store_;
+  std::mutex logMutex_;
+  std::mutex pendingMutex_;
+  std::unordered_set<std::string> pending_; // Queued or being indexed
+  std::unordered_set<std::string> again_;   // Changed since it was queued
+  std::mutex idleMutex_;
+  std::vector<std::unique_ptr<Pipeline>> idle_; // Reused across tasks
+  TaskGroup group_; // Declared last: its destructor waits for the tasks
+
+  void work(const std::string &path) {
+    std::unique_ptr<Pipeline> pipeline;
+    {
+      std::lock_guard<std::mutex> lock(idleMutex_);
+      if (!idle_.empty()) {
+        pipeline = std::move(idle_.back());
+        idle_.pop_back();
+      }
+    }
+    if (!pipeline)
+      pipeline = makePipeline(config_); // Tasks nest while one waits
+
+    do {
+      {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        again_.erase(path); // This run reads the latest contents
+      }
+      index(*pipeline, path);
+    } while (!finished(path));
+
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    idle_.push_back(std::move(pipeline));
+  }
+
+  // Whether a path is done with, or changed again while it was indexed
+  bool finished(const std::string &path) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    if (again_.erase(path))
+      return false;
+    pending_.erase(path);
+    return true;
+  }
+
+  void index(Pipeline &pipeline, const std::string &path) {
+    auto start = std::chrono::steady_clock::now();
+    try {
+      PipelineResult result = pipeline.run(path);
+      store_.put(path, result);
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+      std::lock_guard<std::mutex> lock(logMutex_);
+      std::cerr << "indexed " << path << " (" << result.chunks.size()
+                << " chunks, " << ms << " ms)\n";
+    } catch (const std::exception &e) {
+      std::lock_guard<std::mutex> lock(logMutex_);
+      std::cerr << "failed " << path << ": " << e.what() << "\n";
+    }
+  }
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Config config;
+  std::unique_ptr<Pipeline> pipeline;
+  try {
+    config = parse(argc, argv);
+    pipeline = makePipeline(config);
+  } catch (const std::exception &e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    usage(argv[0]);
+    return 2;
+  }
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = onSignal; // No SA_RESTART: interrupts the poll
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  try {
+    ChunkStore store(config.store);
+    DirectoryWatcher watcher(config.watch);
+    for (const auto &directory : config.directories)
+      watcher.watch(directory);
+
+    if (config.workers) {
+      ThreadPool &pool = ThreadPool::instance();
+      ThreadPoolOptions options = pool.getOptions();
+      options.threads = config.workers;
+      pool.configure(options);
+    }
+
+    Indexer indexer(config, store, std::move(pipeline));
+    while (!stopping) {
+      for (auto &path : watcher.poll(500)) {
+        if (stopping)
+          break; // Left for the next start
+        if (!store.upToDate(path))
+          indexer.add(std::move(path));
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -291,7 +291,11 @@ async def upload_pdf(file: UploadFile = File(...), verify_integrity: bool = True
             warnings=warnings,
             message=f"Processed with security analysis"
         )
-        
+
+    except pdf_shredder.ResourceLimitError as e:
+        # Hostile or oversized document rejected by the native engine
+        raise HTTPException(status_code=413, detail=f"PDF rejected: {str(e)}")
+
     except Exception as e:
         # Ensure cleanup even on error
         if embedding_generator: